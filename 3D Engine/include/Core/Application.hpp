@@ -11,6 +11,8 @@
 
 namespace Saturn {
 
+class Scene;
+
 /**
  * /brief Manages the application.
  *
@@ -31,6 +33,9 @@ public:
         std::string_view window_caption = ""; ///< Window caption
         bool fullscreen =
             false; ///< Whether the window should be fullscreen or not
+        /// Whether frame N is rendered on a separate thread while the scene
+        /// simulates frame N+1. Systems must not call OpenGL functions then.
+        bool pipelined_rendering = false;
     };
 
     /**
@@ -95,9 +100,14 @@ public:
     inline Renderer* get_renderer() { return renderer.get(); }
 
 private:
+    void run_pipelined(Scene& scene);
+
     GLFWwindow* window_handle;   ///< Handle to the GLFW window
     WindowDim window_dimensions; ///< Size of the window
     bool window_is_open;         ///< Indicates whether the window is open
+    bool pipelined_rendering;    ///< Whether run() uses a render thread
+    /// Whether the render thread currently owns the OpenGL context
+    bool render_thread_active = false;
 
     std::unique_ptr<Renderer> renderer =
         nullptr; ///< The main renderer of the application
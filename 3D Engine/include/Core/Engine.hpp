@@ -7,6 +7,7 @@
 #include "Core/Application.hpp"
 #include "Core/ErrorHandler.hpp"
 #include "Subsystems/Input/Input.hpp"
+#include "Subsystems/JobSystem/JobSystem.hpp"
 #include "Subsystems/Logging/LogSystem.hpp"
 #include "Utility/Utility.hpp"
 #include "Subsystems/Math/Math.hpp"
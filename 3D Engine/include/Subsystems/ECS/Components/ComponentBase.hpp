@@ -1,23 +1,17 @@
 #ifndef MVG_COMPONENT_BASE_HPP_
 #define MVG_COMPONENT_BASE_HPP_
 
-#include <cstddef>
-
+#include "Subsystems/ECS/Entity.hpp"
 #include "Subsystems/Serialization/CodeGenDefinitions.hpp"
 
-namespace Saturn {
-class SceneObject;
-}
-
 namespace Saturn {
 
 namespace Components {
 
-// Base struct for components. Does nothing more than storing a pointer to the
-// owning entity and an id referring to itself
+// Base struct for components. Does nothing more than storing a handle to the
+// owning entity. Components are identified by the index of that entity.
 struct ComponentBase {
-    SceneObject* entity;
-    std::size_t id;
+    Entity entity;
 };
 
 } // namespace Components
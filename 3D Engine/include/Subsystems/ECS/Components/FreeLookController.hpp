@@ -7,6 +7,11 @@ namespace Saturn::Components {
 
 struct COMPONENT FreeLookController : public ComponentBase {
     float mouse_sensitivity;
+
+    // Current view angles in degrees. Initialized from the Transform when the
+    // scene starts, not serialized.
+    float pitch = 0.0f;
+    float yaw = 0.0f;
 };
 
 } // namespace Saturn::Components
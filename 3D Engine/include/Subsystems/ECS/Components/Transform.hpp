@@ -5,6 +5,7 @@
 #include "Subsystems/Math/Math.hpp"
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace Saturn {
 
@@ -12,9 +13,16 @@ namespace Components {
 
 struct COMPONENT Transform : public ComponentBase {
     glm::vec3 position = glm::vec3(0.0f, 0.0f, 0.0f);
-    // euler angles rotation
-    glm::vec3 rotation = glm::vec3(0.0f, 0.0f, 0.0f);
+    // Normalized quaternion. Use Math::euler_to_quat to set it from euler
+    // angles in degrees.
+    glm::quat rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
     glm::vec3 scale = glm::vec3(1.0f, 1.0f, 1.0f);
+
+    // Model matrix and rotation matrix including all parent transforms. Kept
+    // up to date by the scene's TransformHierarchy at the end of every
+    // update, not serialized.
+    glm::mat4 world_matrix = glm::mat4(1.0f);
+    glm::mat3 world_rotation = glm::mat3(1.0f);
 };
 
 } // namespace Components
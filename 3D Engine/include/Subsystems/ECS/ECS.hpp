@@ -1,11 +1,28 @@
 #ifndef MVG_ECS_HPP_
 #define MVG_ECS_HPP_
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <typeindex>
+#include <unordered_map>
 #include <vector>
 
-#include "component_container.hpp"
+#include "Entity.hpp"
+#include "change_tick.hpp"
 #include "component_index.hpp"
-#include "component_view.hpp"
+#include "ecs_snapshot.hpp"
+#include "system_scheduler.hpp"
+
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+#    include "archetype_storage.hpp"
+#else
+#    include "component_container.hpp"
+#    include "component_view.hpp"
+#    include "persistent_query.hpp"
+#endif
 
 #include "Systems/SystemBase.hpp"
 
@@ -13,10 +30,23 @@ namespace Saturn {
 
 class Scene;
 
+// Components are stored in one component_container per component type by
+// default. Defining SATURN_ECS_ARCHETYPE_STORAGE switches to archetype_storage,
+// which groups entities with the same set of components in SoA chunks. The
+// interface below is the same for both backends.
+//
+// Component types passed to select, query and get_component may be const
+// qualified. Mutable access marks the accessed components as changed, which
+// Changed<C> filters pick up, so code that only reads components should ask
+// for const ones.
 template<typename... Cs>
 class ECS {
 public:
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+    ECS(Scene* s) : storage(change_tick), scene(s) {}
+#else
     ECS(Scene* s) : scene(s) { create_component_containers<Cs...>(); }
+#endif
     ECS(ECS const&) = delete;
     ECS(ECS&&) = delete;
 
@@ -27,9 +57,14 @@ public:
         for (auto& system : systems) { system->on_start(*scene); }
     }
 
+    // Registers a system. Its reads/writes declarations decide which other
+    // systems it may run concurrently with, see Systems::access
     template<typename S>
     void register_system() {
         systems.push_back(std::make_unique<S>());
+        scheduler.add_system(
+            systems.back().get(),
+            detail::make_system_access<S, component_index_table<Cs...>>());
     }
 
     template<typename Head, typename... Tail>
@@ -38,10 +73,183 @@ public:
         if constexpr (sizeof...(Tail) != 0) register_systems<Tail...>();
     }
 
+    // Runs the variable update systems, once per frame
     void update_systems() {
-        for (auto& system : systems) { system->on_update(*scene); }
+        scheduler.run(*scene, change_tick,
+                      system_scheduler::update_stage::variable);
+    }
+
+    // Runs the systems that declare fixed_update, once per fixed timestep
+    void fixed_update_systems() {
+        scheduler.run(*scene, change_tick,
+                      system_scheduler::update_stage::fixed);
+    }
+
+    bool has_fixed_systems() const {
+        return scheduler.system_count(
+                   system_scheduler::update_stage::fixed) != 0;
+    }
+
+    // The change tick that mutable accesses are currently stamped with
+    std::uint32_t current_tick() const {
+        return change_tick.load(std::memory_order_relaxed);
+    }
+
+    // Returns the current change tick and advances it. Code running outside
+    // of systems, like the renderer, stores the returned tick after it is done
+    // and passes it to Changed or Added filters the next time to see what
+    // changed in between. Its own changes are not included.
+    std::uint32_t advance_tick() { return change_tick.fetch_add(1); }
+
+    // Copies every component into out, reusing its memory. Has to be called
+    // while no systems run. Advances the change tick, so that changes made
+    // after the capture are newer than out.tick().
+    void capture(ecs_snapshot<Cs...>& out) {
+        out.set_tick(advance_tick());
+        (capture_components<Cs>(out), ...);
+    }
+
+    // Systems run concurrently by default. Sequential mode runs them in
+    // registration order on the calling thread.
+    void set_update_mode(system_scheduler::mode mode) {
+        scheduler.set_mode(mode);
+    }
+
+    // Adds a component to owner and returns it
+    template<typename C>
+    C& add_component(Entity owner, C component) {
+        component.entity = owner;
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+        return storage.add(owner, std::move(component));
+#else
+        auto& result =
+            *get_components<C>().push_back(component, current_tick());
+        for (auto& q : queries_of<C>()) { q->on_component_added(owner.index); }
+        return result;
+#endif
+    }
+
+    // Returns the component of type C owned by owner. If C is not const this
+    // marks the component as changed.
+    template<typename C>
+    C& get_component(Entity owner) {
+        auto& component = get_with_id<C>(owner.index);
+        assert(component.entity == owner && "Stale entity handle");
+        return component;
+    }
+
+    // Change ticks of the component of type C owned by owner. With the
+    // archetype backend these are the ticks of the chunk it is stored in.
+    template<typename C>
+    component_ticks get_ticks(Entity owner) {
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+        return storage.template ticks_with_id<C>(owner.index);
+#else
+        return get_components<C>().ticks_with_id(owner.index);
+#endif
+    }
+
+    template<typename C>
+    bool has_component(Entity owner) {
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+        return storage.template contains<C>(owner.index);
+#else
+        return get_components<C>().contains(owner.index);
+#endif
+    }
+
+    template<typename C>
+    void remove_component(Entity owner) {
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+        storage.template remove<C>(owner);
+#else
+        get_components<C>().erase_component(owner.index);
+        for (auto& q : queries_of<C>()) {
+            q->on_component_removed(owner.index);
+        }
+#endif
+    }
+
+    // Removes all components of the given entities. Every component storage
+    // is compacted at most once for the whole batch, so destroying many
+    // entities at once is much cheaper than removing their components one by
+    // one.
+    void destroy_entities(std::vector<Entity> const& entities) {
+        if (entities.empty()) { return; }
+        // Entity indices are dense, so a flag per index is the cheapest
+        // lookup for the compaction passes
+        std::uint32_t max_index = 0;
+        for (auto entity : entities) {
+            max_index = std::max(max_index, entity.index);
+        }
+        std::vector<bool> dead(std::size_t(max_index) + 1);
+        for (auto entity : entities) { dead[entity.index] = true; }
+        auto is_dead = [&dead](Entity entity) {
+            return entity.index < dead.size() && dead[entity.index];
+        };
+
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+        storage.remove_entities(entities, is_dead);
+#else
+        (destroy_components<Cs>(entities, is_dead), ...);
+        for (auto& q : all_queries) { q->on_entities_destroyed(dead); }
+#endif
+    }
+
+    // Makes room for additional components of type C, so that adding them
+    // does not reallocate. Grows geometrically like push_back, so reserving
+    // a few components every frame does not copy the container every time.
+    template<typename C>
+    void reserve(std::size_t additional) {
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+        // Archetype chunks are allocated one at a time and never move
+        (void)additional;
+#else
+        auto& container = get_components<C>();
+        auto const needed = container.size() + additional;
+        if (needed > container.capacity()) {
+            container.reserve(std::max(needed, 2 * container.capacity()));
+        }
+#endif
+    }
+
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+    // Returns a range over all components of type C. The range is a
+    // lightweight object and is returned by value.
+    template<typename C>
+    auto get_components() {
+        return storage.template components<C>();
+    }
+
+    // Grabs all component sets with a specified set of components by walking
+    // the chunks of every matching archetype. Filters (Changed<C>, Added<C>)
+    // are applied per chunk.
+    template<typename... Comps, typename... Filters>
+    auto select(Filters... filters) {
+        using storage_type = archetype_storage<Cs...>;
+        static_assert(sizeof...(Filters) <=
+                          storage_type::template view<Comps...>::max_filters,
+                      "Too many filters");
+        return storage.template select<Comps...>(
+            {storage_type::make_filter(filters)...});
+    }
+
+    // Returns the component of type C owned by the entity with index id
+    template<typename C>
+    C& get_with_id(std::size_t id) {
+        return storage.template get_with_id<C>(id);
+    }
+
+    template<typename... Comps>
+    auto& register_query() {
+        return storage.template register_query<Comps...>();
     }
 
+    template<typename... Comps>
+    auto& query() {
+        return storage.template find_query<Comps...>();
+    }
+#else
     // Assumes that ptr is a valid pointer returned from
     // find_component_container. C is the COMPONENT TYPE
     template<typename C>
@@ -51,19 +259,62 @@ public:
         return *((*any_container).template get_as<component_container<C>>());
     }
 
-    // Grabs all component sets with a specified set of components
-    template<typename... Comps>
-    component_view<Comps...> select() {
-        return component_view<Comps...>(scene->objects.begin(),
-                                     scene->objects.end());
+    // Grabs all component sets with a specified set of components. Iteration
+    // is driven by the smallest of the requested component pools. Only
+    // entities that pass all filters (Changed<C>, Added<C>) are yielded.
+    template<typename... Comps, typename... Filters>
+    component_view<Comps...> select(Filters... filters) {
+        static_assert(sizeof...(Filters) <=
+                          component_view<Comps...>::max_filters,
+                      "Too many filters");
+        component_view<Comps...> view(
+            current_tick(), &get_components<std::remove_const_t<Comps>>()...);
+        (view.add_filter(make_filter(filters)), ...);
+        return view;
     }
 
+    // Returns the component of type C owned by the entity with index id
     template<typename C>
     C& get_with_id(std::size_t id) {
-        auto& container = get_components<C>();
+        auto& container = get_components<std::remove_const_t<C>>();
+        if constexpr (!std::is_const_v<C>) {
+            container.ticks_with_id(id).changed = current_tick();
+        }
         return container.get_with_id(id);
     }
 
+    // Registers a persistent query for Comps, or returns the one registered
+    // earlier. Registering scans the component pools once, afterwards the
+    // query is kept up to date as components are added and removed.
+    // Registration must not happen while systems are running, so systems
+    // register their queries in on_start.
+    template<typename... Comps>
+    persistent_query<Comps...>& register_query() {
+        auto [it, inserted] = query_lookup.try_emplace(
+            std::type_index(typeid(persistent_query<Comps...>)),
+            all_queries.size());
+        if (inserted) {
+            all_queries.push_back(std::make_unique<persistent_query<Comps...>>(
+                &change_tick,
+                &get_components<std::remove_const_t<Comps>>()...));
+            auto* q = all_queries.back().get();
+            (queries_of<std::remove_const_t<Comps>>().push_back(q), ...);
+        }
+        return static_cast<persistent_query<Comps...>&>(
+            *all_queries[it->second]);
+    }
+
+    // Returns a query registered earlier with register_query. Safe to call
+    // from systems running concurrently.
+    template<typename... Comps>
+    persistent_query<Comps...>& query() {
+        auto it = query_lookup.find(
+            std::type_index(typeid(persistent_query<Comps...>)));
+        assert(it != query_lookup.end() && "Query was not registered");
+        return static_cast<persistent_query<Comps...>&>(
+            *all_queries[it->second]);
+    }
+
     template<typename C>
     any_component_container* find_component_container() {
         auto idx = component_indices.template get<C>();
@@ -74,7 +325,7 @@ public:
     template<typename C>
     any_component_container const* find_component_container() const {
         // Warning: Has to be the same implementation as non-const version!
-        auto idx = component_indices.get<C>();
+        auto idx = component_indices.template get<C>();
         if (idx == component_indices.not_found) return nullptr;
         return &(components[idx]);
     }
@@ -87,8 +338,46 @@ public:
 
         // components.back().emplace<component_container<C>>();
     }
+#endif
 
 private:
+    template<typename C>
+    void capture_components(ecs_snapshot<Cs...>& out) {
+        auto& set = out.template components<C>();
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+        set.clear();
+        storage.template for_each_lane<C>(
+            [&set](C const* first, Entity const* owners, std::size_t count,
+                   component_ticks const& ticks) {
+                set.append(first, owners, count, ticks);
+            });
+#else
+        set.assign(get_components<C>());
+#endif
+    }
+
+    // Starts at 1 so that everything counts as changed for code that has
+    // not stored a tick yet
+    std::atomic<std::uint32_t> change_tick{1};
+#ifdef SATURN_ECS_ARCHETYPE_STORAGE
+    archetype_storage<Cs...> storage;
+#else
+    template<typename C, typename Pred>
+    void destroy_components(std::vector<Entity> const& entities,
+                            Pred const& is_dead) {
+        auto& container = get_components<C>();
+        // Skip the pass over containers none of the entities have a
+        // component in
+        bool const any = std::any_of(
+            entities.begin(), entities.end(), [&container](Entity entity) {
+                return container.contains(entity.index);
+            });
+        if (!any) { return; }
+        container.erase_if([&is_dead](C const& component) {
+            return is_dead(component.entity);
+        });
+    }
+
     template<typename Head, typename... Tail>
     void create_component_containers() {
         add_component_container<Head>();
@@ -96,9 +385,33 @@ private:
             create_component_containers<Tail...>();
     }
 
+    template<typename C>
+    detail::tick_filter make_filter(Changed<C> filter) {
+        return {&get_components<C>(), filter.since, false};
+    }
+
+    template<typename C>
+    detail::tick_filter make_filter(Added<C> filter) {
+        return {&get_components<C>(), filter.since, true};
+    }
+
+    // Queries that match on component type C
+    template<typename C>
+    std::vector<detail::query_interface*>& queries_of() {
+        return component_queries[component_indices.template get<C>()];
+    }
+
     std::vector<any_component_container> components;
-    std::vector<std::unique_ptr<Systems::SystemBase>> systems;
     component_index_table<Cs...> component_indices;
+
+    std::vector<std::unique_ptr<detail::query_interface>> all_queries;
+    std::unordered_map<std::type_index, std::size_t> query_lookup;
+    // Registered queries per component type, indexed like components
+    std::array<std::vector<detail::query_interface*>, sizeof...(Cs)>
+        component_queries;
+#endif
+    std::vector<std::unique_ptr<Systems::SystemBase>> systems;
+    system_scheduler scheduler;
     Scene* scene;
 };
 
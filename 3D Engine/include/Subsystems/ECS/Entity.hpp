@@ -0,0 +1,31 @@
+#ifndef MVG_ENTITY_HPP_
+#define MVG_ENTITY_HPP_
+
+#include <cstdint>
+
+namespace Saturn {
+
+// Handle to an object in a Scene. The index refers to a slot in the scene's
+// entity table, and the generation is bumped every time that slot is reused,
+// so handles to destroyed objects can be told apart from live ones.
+struct Entity {
+    static constexpr std::uint32_t invalid_index =
+        static_cast<std::uint32_t>(-1);
+
+    std::uint32_t index = invalid_index;
+    std::uint32_t generation = 0;
+
+    // Whether this handle refers to any entity at all. It may still refer to
+    // one that has been destroyed, Scene::is_alive checks for that.
+    bool valid() const { return index != invalid_index; }
+};
+
+inline bool operator==(Entity lhs, Entity rhs) {
+    return lhs.index == rhs.index && lhs.generation == rhs.generation;
+}
+
+inline bool operator!=(Entity lhs, Entity rhs) { return !(lhs == rhs); }
+
+} // namespace Saturn
+
+#endif
@@ -1,12 +1,18 @@
 #ifndef MVG_CAMERA_ZOOM_CONTROLLER_SYSTEM_HPP_
 #define MVG_CAMERA_ZOOM_CONTROLLER_SYSTEM_HPP_
 
+#include "../Components/Camera.hpp"
+#include "../Components/CameraZoomController.hpp"
 #include "SystemBase.hpp"
 
 namespace Saturn::Systems {
 
 class CameraZoomControllerSystem : public SystemBase {
 public:
+    using reads = access<Components::CameraZoomController>;
+    using writes = access<Components::Camera>;
+
+    void on_start(Scene& scene) override;
     void on_update(Scene& scene) override;
 };
 
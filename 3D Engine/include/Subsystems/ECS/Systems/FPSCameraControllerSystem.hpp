@@ -1,6 +1,9 @@
 #ifndef MVG_FPS_CAMERA_CONTROLLER_SYSTEM_HPP_
 #define MVG_FPS_CAMERA_CONTROLLER_SYSTEM_HPP_
 
+#include "../Components/Camera.hpp"
+#include "../Components/FPSCameraController.hpp"
+#include "../Components/Transform.hpp"
 #include "SystemBase.hpp"
 
 namespace Saturn {
@@ -9,7 +12,12 @@ namespace Systems {
 
 class FPSCameraControllerSystem : public SystemBase {
 public:
-    void on_start(Scene&) override;
+    using reads = access<Components::Camera, Components::FPSCameraController>;
+    using writes = access<Components::Transform>;
+    // Polls keys through GLFW
+    static constexpr bool main_thread_only = true;
+
+    void on_start(Scene& scene) override;
     void on_update(Scene& scene) override;
 
 };
@@ -1,12 +1,18 @@
 #ifndef MVG_FLASHLIGHT_SYSTEM_HPP_
 #define MVG_FLASHLIGHT_SYSTEM_HPP_
 
+#include "../Components/Camera.hpp"
+#include "../Components/SpotLight.hpp"
 #include "SystemBase.hpp"
 
 namespace Saturn::Systems {
 
 class FlashlightSystem : public SystemBase {
 public:
+    using reads = access<Components::Camera>;
+    using writes = access<Components::SpotLight>;
+
+    void on_start(Scene& scene) override;
 	void on_update(Scene& scene) override;
 };
 
@@ -1,12 +1,22 @@
 #ifndef MVG_FREELOOK_CONTROLLER_SYSTEM_HPP_
 #define MVG_FREELOOK_CONTROLLER_SYSTEM_HPP_
 
+#include "../Components/Camera.hpp"
+#include "../Components/FreeLookController.hpp"
+#include "../Components/Transform.hpp"
 #include "SystemBase.hpp"
 
 namespace Saturn::Systems {
 
 class FreeLookControllerSystem : public SystemBase {
 public:
+    using writes = access<Components::Transform,
+                          Components::Camera,
+                          Components::FreeLookController>;
+    // Polls keys through GLFW
+    static constexpr bool main_thread_only = true;
+
+    void on_start(Scene& scene) override;
     void on_update(Scene& scene) override;
 };
 
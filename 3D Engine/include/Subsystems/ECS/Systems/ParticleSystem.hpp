@@ -2,6 +2,7 @@
 #define MVG_PARTICLE_SYSTEM_HPP_
 
 #include "../Components/ParticleEmitter.hpp"
+#include "../Components/Transform.hpp"
 #include "SystemBase.hpp"
 
 namespace Saturn::Systems {
@@ -9,6 +10,9 @@ namespace Saturn::Systems {
 //#TODO: Particles on GPU using compute shaders
 class ParticleSystem : public SystemBase {
 public:
+    using reads = access<Components::Transform>;
+    using writes = access<Components::ParticleEmitter>;
+
     void on_update(Scene& scene) override;
 
 private:
@@ -18,7 +22,7 @@ private:
 
     void remove_expired_particles(Components::ParticleEmitter& emitter);
     void spawn_particle(Components::ParticleEmitter& emitter,
-                        Components::Transform const& abs_transform);
+                        Components::Transform const& transform);
     void update_particle(std::size_t index,
                          Components::ParticleEmitter& emitter);
 
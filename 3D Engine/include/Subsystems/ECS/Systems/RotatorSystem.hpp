@@ -1,9 +1,16 @@
+#include "../Components/Rotator.hpp"
+#include "../Components/Transform.hpp"
 #include "SystemBase.hpp"
 
 namespace Saturn::Systems {
 
 class RotatorSystem : public SystemBase {
 public:
+    using reads = access<Components::Rotator>;
+    using writes = access<Components::Transform>;
+    static constexpr bool fixed_update = true;
+
+    void on_start(Scene& scene) override;
     void on_update(Scene& scene) override;
 };
 
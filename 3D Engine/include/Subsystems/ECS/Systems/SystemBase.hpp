@@ -1,19 +1,58 @@
 #ifndef MVG_SYSTEM_BASE_HPP_
 #define MVG_SYSTEM_BASE_HPP_
 
+#include <cstdint>
+
 namespace Saturn {
 class Scene;
+class system_scheduler;
 }
 
 namespace Saturn {
 namespace Systems {
 
+// List of component types, used by systems to declare which components they
+// access during on_update:
+//
+//     using reads = access<Components::Rotator>;
+//     using writes = access<Components::Transform>;
+//
+// Systems that declare neither are never run concurrently with any other
+// system. Systems that must run on the main thread (because they call OpenGL
+// or GLFW functions) also declare
+//
+//     static constexpr bool main_thread_only = true;
+//
+// Systems run once per frame with a variable Time::deltaTime by default.
+// Simulation systems that should run at the fixed tick rate of
+// Time::fixedDeltaTime declare
+//
+//     static constexpr bool fixed_update = true;
+//
+// While they run, Time::deltaTime is the fixed step length.
+template<typename... Cs>
+struct access {};
+
 class SystemBase {
 public:
     virtual ~SystemBase() = 0;
 
 	virtual void on_start(Scene& scene);
+    // Systems may run concurrently and while other systems iterate over
+    // components, so on_update must not create or destroy objects or add or
+    // remove components directly. Record those changes in
+    // Scene::get_commands() instead.
     virtual void on_update(Scene& scene) = 0;
+
+    // Change tick at the end of the previous on_update call. Pass it to
+    // Changed or Added filters to only see what changed since then, not
+    // counting changes made by this system itself.
+    std::uint32_t last_run_tick() const { return last_run; }
+
+private:
+    friend class ::Saturn::system_scheduler;
+
+    std::uint32_t last_run = 0;
 };
 
 
@@ -0,0 +1,761 @@
+#ifndef MVG_ARCHETYPE_STORAGE_HPP_
+#define MVG_ARCHETYPE_STORAGE_HPP_
+
+#include "Entity.hpp"
+#include "Subsystems/JobSystem/JobSystem.hpp"
+#include "change_tick.hpp"
+#include "component_index.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <typeindex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Saturn {
+
+namespace detail {
+
+// Type erased operations on a single component type. Archetypes use these to
+// move and destroy the components in their chunks without knowing the types.
+struct component_lane_info {
+    std::size_t size;
+    std::size_t alignment;
+    void (*move_construct)(void* dst, void* src);
+    void (*destroy)(void* obj);
+};
+
+template<typename C>
+component_lane_info make_lane_info() {
+    return {sizeof(C), alignof(C),
+            [](void* dst, void* src) {
+                new (dst) C(std::move(*static_cast<C*>(src)));
+            },
+            [](void* obj) { static_cast<C*>(obj)->~C(); }};
+}
+
+} // namespace detail
+
+// Alternative storage backend for the ECS. All entities with the exact same
+// set of components share an archetype. An archetype stores its rows in fixed
+// size chunks, and inside a chunk every component type has its own contiguous
+// lane (SoA). Queries walk the chunks of all matching archetypes linearly
+// instead of joining separate per-component arrays.
+//
+// Change ticks are tracked per chunk and component type rather than per
+// component, so Changed and Added filters work on whole chunks: a filtered
+// view yields every row of a chunk in which at least one component passes.
+template<typename... Cs>
+class archetype_storage {
+public:
+    using component_table = component_index_table<Cs...>;
+    static constexpr std::size_t component_count = sizeof...(Cs);
+    static constexpr std::size_t chunk_size = 16 * 1024;
+
+    using signature_type = std::bitset<component_count>;
+    using lane_table = std::array<detail::component_lane_info, component_count>;
+
+    struct alignas(64) chunk {
+        std::byte data[chunk_size];
+    };
+
+    class archetype {
+    public:
+        archetype(signature_type s, lane_table const& l) :
+            sig(s), lanes(&l) {
+            // Bytes per row, and an upper bound for the alignment padding
+            // between lanes
+            std::size_t row_size = sizeof(Entity);
+            std::size_t padding = 0;
+            for (std::size_t i = 0; i < component_count; ++i) {
+                if (!sig[i]) { continue; }
+                row_size += l[i].size;
+                padding += l[i].alignment;
+            }
+            capacity = (chunk_size - padding) / row_size;
+            assert(capacity > 0 && "Archetype row does not fit in a chunk");
+
+            // The owning entities are stored in the first lane
+            std::size_t offset = capacity * sizeof(Entity);
+            for (std::size_t i = 0; i < component_count; ++i) {
+                if (!sig[i]) { continue; }
+                offset = (offset + l[i].alignment - 1) / l[i].alignment *
+                         l[i].alignment;
+                offsets[i] = offset;
+                offset += capacity * l[i].size;
+            }
+        }
+
+        archetype(archetype const&) = delete;
+        archetype& operator=(archetype const&) = delete;
+
+        ~archetype() {
+            for (std::size_t row = 0; row < count; ++row) {
+                for (std::size_t i = 0; i < component_count; ++i) {
+                    if (sig[i]) { (*lanes)[i].destroy(component_at(i, row)); }
+                }
+            }
+        }
+
+        signature_type const& signature() const { return sig; }
+        std::size_t size() const { return count; }
+        std::size_t chunk_count() const { return chunks.size(); }
+        std::size_t chunk_capacity() const { return capacity; }
+
+        // Amount of rows in use in a chunk. Every chunk except the last one
+        // is full.
+        std::size_t rows_in_chunk(std::size_t chunk_idx) const {
+            return std::min(capacity, count - chunk_idx * capacity);
+        }
+
+        // Returns the lane of component C in a chunk. The archetype must
+        // contain C.
+        template<typename C>
+        C* lane(std::size_t chunk_idx) {
+            constexpr auto idx = index_of<C>();
+            assert(sig[idx]);
+            return reinterpret_cast<C*>(chunks[chunk_idx]->data + offsets[idx]);
+        }
+
+        // Change ticks of a component type in a chunk
+        component_ticks& ticks(std::size_t chunk_idx, std::size_t idx) {
+            return chunk_ticks[chunk_idx][idx];
+        }
+
+        // Marks the lane of component idx in a chunk as changed
+        void stamp_changed(std::size_t chunk_idx,
+                           std::size_t idx,
+                           std::uint32_t tick) {
+            chunk_ticks[chunk_idx][idx].changed = tick;
+        }
+
+        Entity* entities(std::size_t chunk_idx) {
+            return reinterpret_cast<Entity*>(chunks[chunk_idx]->data);
+        }
+
+        Entity& entity_at(std::size_t row) {
+            return entities(row / capacity)[row % capacity];
+        }
+
+        void* component_at(std::size_t idx, std::size_t row) {
+            return chunks[row / capacity]->data + offsets[idx] +
+                   (row % capacity) * (*lanes)[idx].size;
+        }
+
+        // Appends a row for entity. The components in the new row are not
+        // constructed yet.
+        std::size_t push_row(Entity entity) {
+            if (count == chunks.size() * capacity) {
+                chunks.push_back(std::make_unique<chunk>());
+                chunk_ticks.emplace_back();
+            }
+            auto row = count++;
+            entity_at(row) = entity;
+            return row;
+        }
+
+        // Makes the ticks of the chunk holding row at least as new as the
+        // given ticks. Used when components move into the chunk, so filters
+        // do not lose track of changes made before the move.
+        void merge_ticks(std::size_t row,
+                         std::size_t idx,
+                         component_ticks const& from) {
+            auto& to = chunk_ticks[row / capacity][idx];
+            if (tick_newer(from.added, to.added)) { to.added = from.added; }
+            if (tick_newer(from.changed, to.changed)) {
+                to.changed = from.changed;
+            }
+        }
+
+        component_ticks const& row_ticks(std::size_t row,
+                                         std::size_t idx) const {
+            return chunk_ticks[row / capacity][idx];
+        }
+
+        // Destroys the components in a row and fills the hole with the last
+        // row. Returns the entity that was moved into the row, or an invalid
+        // entity if the erased row was the last one.
+        Entity erase_row(std::size_t row) {
+            auto const last = count - 1;
+            for (std::size_t i = 0; i < component_count; ++i) {
+                if (!sig[i]) { continue; }
+                auto const& l = (*lanes)[i];
+                l.destroy(component_at(i, row));
+                if (row != last) {
+                    l.move_construct(component_at(i, row),
+                                     component_at(i, last));
+                    l.destroy(component_at(i, last));
+                    merge_ticks(row, i, row_ticks(last, i));
+                }
+            }
+            Entity moved;
+            if (row != last) {
+                moved = entity_at(last);
+                entity_at(row) = moved;
+            }
+            --count;
+            // Release the last chunk once it is empty
+            if (count == (chunks.size() - 1) * capacity) {
+                chunks.pop_back();
+                chunk_ticks.pop_back();
+            }
+            return moved;
+        }
+
+        // Erases every row whose entity satisfies pred in a single pass,
+        // moving the remaining rows down in order. Returns the first row that
+        // changed, or the new size if no rows were erased.
+        template<typename Pred>
+        std::size_t erase_rows_if(Pred pred) {
+            std::size_t first_changed = count;
+            std::size_t kept = 0;
+            for (std::size_t row = 0; row < count; ++row) {
+                bool const erase = pred(entity_at(row));
+                for (std::size_t i = 0; i < component_count; ++i) {
+                    if (!sig[i]) { continue; }
+                    auto const& l = (*lanes)[i];
+                    if (!erase && kept != row) {
+                        l.move_construct(component_at(i, kept),
+                                         component_at(i, row));
+                        merge_ticks(kept, i, row_ticks(row, i));
+                    }
+                    if (erase || kept != row) {
+                        l.destroy(component_at(i, row));
+                    }
+                }
+                if (erase) {
+                    first_changed = std::min(first_changed, row);
+                    continue;
+                }
+                if (kept != row) { entity_at(kept) = entity_at(row); }
+                ++kept;
+            }
+            count = kept;
+            chunks.resize((count + capacity - 1) / capacity);
+            chunk_ticks.resize(chunks.size());
+            return std::min(first_changed, count);
+        }
+
+    private:
+        signature_type sig;
+        lane_table const* lanes;
+        // Byte offset of each component lane in a chunk. Only valid for the
+        // components in sig
+        std::array<std::size_t, component_count> offsets{};
+        std::size_t capacity = 0;
+        std::size_t count = 0;
+        std::vector<std::unique_ptr<chunk>> chunks;
+        // Change ticks per chunk and component type
+        std::vector<std::array<component_ticks, component_count>> chunk_ticks;
+    };
+
+    // Changed or Added filter on a component type
+    struct chunk_filter {
+        std::size_t component;
+        std::uint32_t since;
+        bool added;
+
+        bool matches(archetype& arch, std::size_t chunk_idx) const {
+            auto const& ticks = arch.ticks(chunk_idx, component);
+            return tick_newer(added ? ticks.added : ticks.changed, since);
+        }
+    };
+
+    // Iterates over the components Qs of every entity that has all of them,
+    // one chunk at a time. Qs may be const qualified. Walking a chunk marks
+    // the lanes of the non-const components in it as changed.
+    template<typename... Qs>
+    class view {
+    public:
+        // Most filters a view can take. They are stored in the view, so
+        // they do not allocate.
+        static constexpr std::size_t max_filters = 4;
+
+        // Empty archetypes are skipped unless include_empty is set. Only
+        // chunks that pass every filter are walked.
+        explicit view(archetype_storage& storage,
+                      bool include_empty = false,
+                      std::initializer_list<chunk_filter> chunk_filters = {}) :
+            storage(&storage) {
+            assert(chunk_filters.size() <= max_filters && "Too many filters");
+            for (auto const& filter : chunk_filters) {
+                filters[filter_count++] = filter;
+                mask.set(filter.component);
+            }
+            for (auto& arch : storage.archetypes) {
+                if (include_empty || arch->size() != 0) { include(*arch); }
+            }
+        }
+
+        // Adds arch to the archetypes this view walks if it matches
+        void include(archetype& arch) {
+            if ((arch.signature() & mask) == mask) {
+                matching.push_back(&arch);
+            }
+        }
+
+        class iterator {
+        public:
+            iterator() = default;
+            iterator(view const* v, std::size_t arch) :
+                owner(v), arch_idx(arch) {
+                tick = owner->storage->current_tick();
+                load_chunk();
+            }
+
+            std::tuple<Qs&...> operator*() const {
+                return std::tuple<Qs&...>(std::get<Qs*>(lanes)[row]...);
+            }
+
+            // prefix increment
+            iterator& operator++() {
+                if (++row == rows) {
+                    row = 0;
+                    ++chunk_idx;
+                    load_chunk();
+                }
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator copy = *this;
+                ++(*this);
+                return copy;
+            }
+
+            bool operator==(iterator const& rhs) const {
+                return arch_idx == rhs.arch_idx &&
+                       chunk_idx == rhs.chunk_idx && row == rhs.row;
+            }
+            bool operator!=(iterator const& rhs) const {
+                return !(*this == rhs);
+            }
+
+        private:
+            // Points the lanes at the current chunk, moving on to the next
+            // matching archetype when this one is exhausted
+            void load_chunk() {
+                auto const& matching = owner->matching;
+                for (; arch_idx < matching.size(); ++arch_idx, chunk_idx = 0) {
+                    auto* arch = matching[arch_idx];
+                    for (; chunk_idx < arch->chunk_count(); ++chunk_idx) {
+                        if (!owner->passes(*arch, chunk_idx)) { continue; }
+                        stamp_chunk<Qs...>(*arch, chunk_idx, tick);
+                        lanes = std::tuple<Qs*...>(
+                            arch->template lane<Qs>(chunk_idx)...);
+                        rows = arch->rows_in_chunk(chunk_idx);
+                        return;
+                    }
+                }
+                chunk_idx = 0;
+            }
+
+            view const* owner = nullptr;
+            std::uint32_t tick = 0;
+            std::size_t arch_idx = 0;
+            std::size_t chunk_idx = 0;
+            std::size_t row = 0;
+            std::size_t rows = 0;
+            std::tuple<Qs*...> lanes;
+        };
+
+        iterator begin() const { return iterator{this, 0}; }
+        iterator end() const { return iterator{this, matching.size()}; }
+
+        // Amount of entities this view will yield, ignoring filters
+        std::size_t size_hint() const {
+            std::size_t result = 0;
+            for (auto* arch : matching) { result += arch->size(); }
+            return result;
+        }
+
+        // Calls fn(Qs&...) for every matching entity. Chunks are split into
+        // ranges of at most grain_size rows that are processed on the job
+        // system, so every entity is visited exactly once. fn must not add or
+        // remove components.
+        template<typename F>
+        void parallel_for_each(F&& fn, std::size_t grain_size = 1024) {
+            struct row_range {
+                archetype* arch;
+                std::size_t chunk_idx;
+                std::size_t begin;
+                std::size_t end;
+            };
+            grain_size = std::max<std::size_t>(grain_size, 1);
+            auto const tick = storage->current_tick();
+            std::vector<row_range> ranges;
+            for (auto* arch : matching) {
+                for (std::size_t c = 0; c < arch->chunk_count(); ++c) {
+                    if (!passes(*arch, c)) { continue; }
+                    // Stamped here so that the workers never write ticks
+                    stamp_chunk<Qs...>(*arch, c, tick);
+                    auto const rows = arch->rows_in_chunk(c);
+                    for (std::size_t r = 0; r < rows; r += grain_size) {
+                        ranges.push_back(
+                            {arch, c, r, std::min(r + grain_size, rows)});
+                    }
+                }
+            }
+
+            JobSystem::parallel_for(
+                ranges.size(), 1,
+                [&ranges, &fn](std::size_t begin, std::size_t end) {
+                    for (auto i = begin; i != end; ++i) {
+                        auto const& range = ranges[i];
+                        auto lanes = std::tuple<Qs*...>(
+                            range.arch->template lane<Qs>(range.chunk_idx)...);
+                        for (auto row = range.begin; row != range.end; ++row) {
+                            fn(std::get<Qs*>(lanes)[row]...);
+                        }
+                    }
+                });
+        }
+
+    private:
+        bool passes(archetype& arch, std::size_t chunk_idx) const {
+            for (std::size_t i = 0; i < filter_count; ++i) {
+                if (!filters[i].matches(arch, chunk_idx)) { return false; }
+            }
+            return true;
+        }
+
+        archetype_storage* storage;
+        signature_type mask = signature_of<Qs...>();
+        std::array<chunk_filter, max_filters> filters{};
+        std::size_t filter_count = 0;
+        std::vector<archetype*> matching;
+    };
+
+    // All components of a single type, in chunk order. This is what
+    // ECS::get_components returns with this backend.
+    template<typename C>
+    class component_range {
+    public:
+        explicit component_range(archetype_storage& s) :
+            storage(&s), all(s) {}
+
+        class iterator {
+        public:
+            iterator() = default;
+            explicit iterator(typename view<C>::iterator i) : it(i) {}
+
+            C& operator*() const { return std::get<0>(*it); }
+            C* operator->() const { return &std::get<0>(*it); }
+
+            iterator& operator++() {
+                ++it;
+                return *this;
+            }
+
+            iterator operator++(int) {
+                iterator copy = *this;
+                ++(*this);
+                return copy;
+            }
+
+            bool operator==(iterator const& rhs) const { return it == rhs.it; }
+            bool operator!=(iterator const& rhs) const { return it != rhs.it; }
+
+        private:
+            typename view<C>::iterator it;
+        };
+
+        iterator begin() const { return iterator{all.begin()}; }
+        iterator end() const { return iterator{all.end()}; }
+
+        std::size_t size() const { return all.size_hint(); }
+
+        bool contains(std::size_t id) const {
+            return storage->template contains<C>(id);
+        }
+
+        C& get_with_id(std::size_t id) {
+            return storage->template get_with_id<C>(id);
+        }
+
+    private:
+        archetype_storage* storage;
+        view<C> all;
+    };
+
+    class query_base {
+    public:
+        virtual ~query_base() = default;
+        virtual void on_archetype_created(archetype& arch) = 0;
+    };
+
+    // Persistent version of view. It caches the list of matching archetypes
+    // and is told about every archetype created later, so it never has to
+    // search the archetype list again. Entities moving between archetypes do
+    // not affect the list at all.
+    template<typename... Qs>
+    class query : public query_base, public view<Qs...> {
+    public:
+        explicit query(archetype_storage& storage) :
+            view<Qs...>(storage, true) {}
+
+        void on_archetype_created(archetype& arch) override {
+            this->include(arch);
+        }
+
+        std::size_t size() const { return this->size_hint(); }
+    };
+
+    // tick is the change tick of the ECS owning this storage
+    explicit archetype_storage(std::atomic<std::uint32_t> const& tick) :
+        lanes{detail::make_lane_info<Cs>()...}, tick(&tick) {}
+    archetype_storage(archetype_storage const&) = delete;
+    archetype_storage& operator=(archetype_storage const&) = delete;
+
+    template<typename... Qs>
+    static signature_type signature_of() {
+        signature_type result;
+        (result.set(index_of<Qs>()), ...);
+        return result;
+    }
+
+    std::uint32_t current_tick() const {
+        return tick->load(std::memory_order_relaxed);
+    }
+
+    // Adds a component to entity, moving the entity to the archetype for its
+    // new set of components
+    template<typename C>
+    C& add(Entity entity, C component) {
+        constexpr auto idx = index_of<C>();
+        if (entity.index >= locations.size()) {
+            locations.resize(entity.index + 1);
+        }
+        auto& loc = locations[entity.index];
+        auto sig = loc.arch ? loc.arch->signature() : signature_type{};
+        assert(!sig[idx] && "Entity already has this component");
+        sig.set(idx);
+
+        auto& target = find_or_create_archetype(sig);
+        auto const row = target.push_row(entity);
+        if (loc.arch) { move_row(*loc.arch, loc.row, target, row); }
+        loc = location{&target, row};
+
+        auto const now = current_tick();
+        target.merge_ticks(row, idx, component_ticks{now, now});
+        auto* c = new (target.component_at(idx, row)) C(std::move(component));
+        c->entity = entity;
+        return *c;
+    }
+
+    // Removes a component from entity, moving it to the archetype for its
+    // remaining components
+    template<typename C>
+    void remove(Entity entity) {
+        constexpr auto idx = index_of<C>();
+        assert(contains<C>(entity.index) && "Entity does not have component");
+        auto const loc = locations[entity.index];
+
+        auto sig = loc.arch->signature();
+        sig.reset(idx);
+        if (sig.none()) {
+            locations[entity.index] = location{};
+            erase_row(*loc.arch, loc.row);
+            return;
+        }
+
+        auto& target = find_or_create_archetype(sig);
+        auto const row = target.push_row(entity);
+        locations[entity.index] = location{&target, row};
+        move_row(*loc.arch, loc.row, target, row);
+    }
+
+    // Removes all components of every entity for which is_dead(entity)
+    // returns true. Only archetypes that hold one of the entities are touched,
+    // and each of them is compacted in a single pass.
+    template<typename Pred>
+    void remove_entities(std::vector<Entity> const& entities, Pred is_dead) {
+        std::vector<archetype*> affected;
+        for (auto entity : entities) {
+            if (entity.index >= locations.size()) { continue; }
+            auto& loc = locations[entity.index];
+            if (!loc.arch) { continue; }
+            if (std::find(affected.begin(), affected.end(), loc.arch) ==
+                affected.end()) {
+                affected.push_back(loc.arch);
+            }
+            loc = location{};
+        }
+
+        for (auto* arch : affected) {
+            auto const first = arch->erase_rows_if(is_dead);
+            // Rows after the first erased one have moved
+            for (auto row = first; row < arch->size(); ++row) {
+                locations[arch->entity_at(row).index].row = row;
+            }
+        }
+    }
+
+    template<typename C>
+    C& get(Entity entity) {
+        return get_with_id<C>(entity.index);
+    }
+
+    // Whether the entity with this index has a component of type C
+    template<typename C>
+    bool contains(std::size_t id) const {
+        if (id >= locations.size()) { return false; }
+        auto const* arch = locations[id].arch;
+        return arch != nullptr && arch->signature()[index_of<C>()];
+    }
+
+    // Returns the component of type C owned by the entity with this index.
+    // If C is not const this marks the component as changed.
+    template<typename C>
+    C& get_with_id(std::size_t id) {
+        constexpr auto idx = index_of<C>();
+        assert(contains<C>(id) && "Entity does not have component");
+        auto const& loc = locations[id];
+        if constexpr (!std::is_const_v<C>) {
+            loc.arch->stamp_changed(loc.row / loc.arch->chunk_capacity(), idx,
+                                    current_tick());
+        }
+        return *static_cast<C*>(loc.arch->component_at(idx, loc.row));
+    }
+
+    // Change ticks of the chunk holding the component of type C owned by the
+    // entity with this index
+    template<typename C>
+    component_ticks const& ticks_with_id(std::size_t id) const {
+        assert(contains<C>(id) && "Entity does not have component");
+        auto const& loc = locations[id];
+        return loc.arch->row_ticks(loc.row, index_of<C>());
+    }
+
+    template<typename... Qs>
+    view<Qs...> select(std::initializer_list<chunk_filter> filters = {}) {
+        return view<Qs...>(*this, false, filters);
+    }
+
+    template<typename C>
+    static chunk_filter make_filter(Changed<C> filter) {
+        return chunk_filter{index_of<C>(), filter.since, false};
+    }
+
+    template<typename C>
+    static chunk_filter make_filter(Added<C> filter) {
+        return chunk_filter{index_of<C>(), filter.since, true};
+    }
+
+    // Registers a persistent query for Qs, or returns the one registered
+    // earlier
+    template<typename... Qs>
+    query<Qs...>& register_query() {
+        auto& slot = queries[std::type_index(typeid(query<Qs...>))];
+        if (!slot) { slot = std::make_unique<query<Qs...>>(*this); }
+        return static_cast<query<Qs...>&>(*slot);
+    }
+
+    // Returns a query registered earlier with register_query
+    template<typename... Qs>
+    query<Qs...>& find_query() {
+        auto it = queries.find(std::type_index(typeid(query<Qs...>)));
+        assert(it != queries.end() && "Query was not registered");
+        return static_cast<query<Qs...>&>(*it->second);
+    }
+
+    template<typename C>
+    component_range<C> components() {
+        return component_range<C>(*this);
+    }
+
+    // Calls f(components, owners, count, ticks) with the lane of C in every
+    // chunk that stores C. Used for bulk copies of whole lanes.
+    template<typename C, typename F>
+    void for_each_lane(F&& f) {
+        constexpr auto idx = index_of<C>();
+        for (auto& arch : archetypes) {
+            if (!arch->signature()[idx]) { continue; }
+            for (std::size_t c = 0; c < arch->chunk_count(); ++c) {
+                f(static_cast<C const*>(arch->template lane<C>(c)),
+                  static_cast<Entity const*>(arch->entities(c)),
+                  arch->rows_in_chunk(c), arch->ticks(c, idx));
+            }
+        }
+    }
+
+private:
+    struct location {
+        archetype* arch = nullptr;
+        std::size_t row = 0;
+    };
+
+    template<typename C>
+    static constexpr std::size_t index_of() {
+        constexpr auto idx =
+            component_table::template get<std::remove_const_t<C>>();
+        static_assert(idx != component_table::not_found,
+                      "Component type is not stored in this ECS");
+        return idx;
+    }
+
+    // Marks the lanes of the non-const components among Qs in a chunk as
+    // changed
+    template<typename... Qs>
+    static void
+    stamp_chunk(archetype& arch, std::size_t chunk_idx, std::uint32_t tick) {
+        ((std::is_const_v<Qs>
+              ? void()
+              : arch.stamp_changed(chunk_idx, index_of<Qs>(), tick)),
+         ...);
+    }
+
+    archetype& find_or_create_archetype(signature_type const& sig) {
+        auto it = archetype_lookup.find(sig);
+        if (it != archetype_lookup.end()) { return *archetypes[it->second]; }
+        archetype_lookup.emplace(sig, archetypes.size());
+        archetypes.push_back(std::make_unique<archetype>(sig, lanes));
+        auto& created = *archetypes.back();
+        for (auto& [type, q] : queries) { q->on_archetype_created(created); }
+        return created;
+    }
+
+    // Moves the components shared by both archetypes from one row to another
+    // and erases the source row
+    void move_row(archetype& src,
+                  std::size_t src_row,
+                  archetype& dst,
+                  std::size_t dst_row) {
+        auto const shared = src.signature() & dst.signature();
+        for (std::size_t i = 0; i < component_count; ++i) {
+            if (shared[i]) {
+                lanes[i].move_construct(dst.component_at(i, dst_row),
+                                        src.component_at(i, src_row));
+                dst.merge_ticks(dst_row, i, src.row_ticks(src_row, i));
+            }
+        }
+        erase_row(src, src_row);
+    }
+
+    void erase_row(archetype& arch, std::size_t row) {
+        auto const moved = arch.erase_row(row);
+        if (moved.valid()) { locations[moved.index].row = row; }
+    }
+
+    lane_table lanes;
+    std::atomic<std::uint32_t> const* tick;
+    std::vector<std::unique_ptr<archetype>> archetypes;
+    std::unordered_map<signature_type, std::size_t> archetype_lookup;
+    // Where the components of each entity are stored, indexed by entity index
+    std::vector<location> locations;
+    std::unordered_map<std::type_index, std::unique_ptr<query_base>> queries;
+};
+
+} // namespace Saturn
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef MVG_CHANGE_TICK_HPP_
+#define MVG_CHANGE_TICK_HPP_
+
+#include <cstdint>
+
+namespace Saturn {
+
+// The ECS keeps a change tick that is advanced every time a system finishes
+// running. Components remember the tick at which they were added and the tick
+// of the last mutable access to them, so later code can ask what changed
+// since a tick it stored earlier.
+struct component_ticks {
+    std::uint32_t added = 0;
+    std::uint32_t changed = 0;
+};
+
+// Whether tick is later than since. Ticks are compared by their difference,
+// so this stays correct when the counter wraps around.
+inline bool tick_newer(std::uint32_t tick, std::uint32_t since) {
+    return static_cast<std::int32_t>(tick - since) > 0;
+}
+
+// Query filters. Passed to ECS::select to only yield entities whose component
+// C was changed (accessed mutably) or added after the tick since. The filtered
+// component does not need to be one of the selected components, but the
+// entity must have it. Systems should pass their last_run_tick().
+template<typename C>
+struct Changed {
+    std::uint32_t since = 0;
+};
+
+template<typename C>
+struct Added {
+    std::uint32_t since = 0;
+};
+
+} // namespace Saturn
+
+#endif
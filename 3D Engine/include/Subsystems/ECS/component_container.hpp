@@ -1,12 +1,13 @@
 #ifndef MVG_COMPONENT_CONTAINER_HPP_
 #define MVG_COMPONENT_CONTAINER_HPP_
 
-#include "Utility/IDGenerator.hpp"
 #include "Utility/type_erased.hpp"
+#include "change_tick.hpp"
+#include "sparse_page_table.hpp"
 
 #include <algorithm>
+#include <cassert>
 #include <typeinfo>
-#include <unordered_map>
 #include <vector>
 
 namespace Saturn {
@@ -18,10 +19,18 @@ public:
     virtual ~component_container_interface() = 0;
 
     virtual std::type_info const& get_component_type() const = 0;
+
+    // Returns the change ticks of the component owned by the entity with
+    // index id, or nullptr if that entity has no component in this container
+    virtual component_ticks const* find_ticks(std::size_t id) const = 0;
 };
 
 } // namespace detail
 
+// Stores all components of type C densely. Components are identified by the
+// index of their owning entity, so an entity can have at most one component
+// of each type. The change ticks of every component are stored in a separate
+// array next to the components.
 template<typename C>
 class component_container : public detail::component_container_interface {
 public:
@@ -46,38 +55,108 @@ public:
         return typeid(C);
     }
 
-    iterator push_back(C const& c) {
+    component_ticks const* find_ticks(std::size_t id) const override {
+        if (!contains(id)) { return nullptr; }
+        return &ticks[index_of(id)];
+    }
+
+    // Adds a component. Its entity member must already be set to the owning
+    // entity. tick is stored as both its added and changed tick.
+    iterator push_back(C const& c, std::uint32_t tick = 0) {
+        auto id = static_cast<std::size_t>(c.entity.index);
+        assert(!contains(id) && "Entity already has a component of this type");
         components.push_back(c);
-        auto id = IDGenerator<C>::next();
-        components.back().id = id;                // Assign correct id
-        id_index_map[id] = components.size() - 1; // Update index map
+        ticks.push_back(component_ticks{tick, tick});
+        id_index_map.slot(id) = components.size() - 1; // Update index map
         return components.end() - 1;
     }
 
     iterator erase_component(std::size_t id) {
-        // Algorithm for erasing and updating indices:
+        // Algorithm for erasing and updating indices (swap and pop):
         /*
-        1. Swap element to erase with last element
-        2. Update index for swapped elements
-        3. Erase
+        1. Move last element into the slot of the element to erase
+        2. Update index for the moved element
+        3. Pop the (now duplicate) last element
         */
 
-        auto id_to_update = components.back().id;
-        auto erased_idx = id_index_map.at(id);
-        std::swap(components[erased_idx], components.back());
-        id_index_map[id_to_update] = erased_idx;
-        return components.erase(components.end() - 1);
+        auto erased_idx = index_of(id);
+        auto last_idx = components.size() - 1;
+        if (erased_idx != last_idx) {
+            auto id_to_update =
+                static_cast<std::size_t>(components.back().entity.index);
+            components[erased_idx] = std::move(components.back());
+            ticks[erased_idx] = ticks.back();
+            id_index_map.slot(id_to_update) = erased_idx;
+        }
+        id_index_map.reset(id);
+        components.pop_back();
+        ticks.pop_back();
+        return components.begin() + erased_idx;
     }
 
-    reference get_with_id(std::size_t id) {
-        return (*this)[id_index_map.at(id)];
+    // Erases every component for which pred(component) returns true in a
+    // single pass over the dense array. Unlike erase_component this keeps the
+    // order of the remaining components, and the cost does not depend on the
+    // amount of erased components.
+    template<typename Pred>
+    void erase_if(Pred pred) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < components.size(); ++i) {
+            auto id = static_cast<std::size_t>(components[i].entity.index);
+            if (pred(static_cast<const_reference>(components[i]))) {
+                id_index_map.reset(id);
+                continue;
+            }
+            if (kept != i) {
+                components[kept] = std::move(components[i]);
+                ticks[kept] = ticks[i];
+                id_index_map.slot(id) = kept;
+            }
+            ++kept;
+        }
+        components.erase(components.begin() + kept, components.end());
+        ticks.resize(kept);
     }
 
+    reference get_with_id(std::size_t id) { return (*this)[index_of(id)]; }
+
     const_reference get_with_id(std::size_t id) const {
-        return (*this)[id_index_map.at(id)];
+        return (*this)[index_of(id)];
+    }
+
+    bool contains(std::size_t id) const { return id_index_map.contains(id); }
+
+    // Returns the index into the dense array for the component with this id.
+    // The id must be stored in this container.
+    std::size_t index_of(std::size_t id) const {
+        assert(contains(id) && "Component id not stored in this container");
+        return id_index_map.get(id);
+    }
+
+    // Change ticks of the component at index in the dense array
+    component_ticks& ticks_at(std::size_t index) { return ticks[index]; }
+    component_ticks const& ticks_at(std::size_t index) const {
+        return ticks[index];
+    }
+
+    component_ticks& ticks_with_id(std::size_t id) {
+        return ticks[index_of(id)];
+    }
+
+    // Contiguous views of the dense arrays, for bulk copies
+    C const* data() const { return components.data(); }
+    component_ticks const* ticks_data() const { return ticks.data(); }
+    detail::sparse_page_table<std::size_t> const& index_table() const {
+        return id_index_map;
+    }
+
+    void reserve(std::size_t count) {
+        components.reserve(count);
+        ticks.reserve(count);
     }
 
     std::size_t size() const { return components.size(); }
+    std::size_t capacity() const { return components.capacity(); }
     bool empty() const { return components.empty(); }
 
     iterator begin() { return components.begin(); }
@@ -98,8 +177,14 @@ private:
     reference at(std::size_t index) { return components.at(index); }
     const_reference at(std::size_t index) const { return components.at(index); }
 
+    static constexpr std::size_t invalid_index = static_cast<std::size_t>(-1);
+
+    // Dense component storage. Iteration only ever touches this array
     std::vector<C> components;
-    std::unordered_map<std::size_t, std::size_t> id_index_map;
+    // Change ticks, in the same order as components
+    std::vector<component_ticks> ticks;
+    // Paged sparse set mapping an entity index to its index in components
+    detail::sparse_page_table<std::size_t> id_index_map{invalid_index};
 };
 
 // Scene will store a vector<mvg::type_erased<container_iterface,
@@ -35,11 +35,12 @@ struct index_of {
 template<typename... Cs>
 struct component_index_table {
     template<typename C>
-    std::size_t get() const {
+    static constexpr std::size_t get() {
         return detail::index_of<C, Cs...>::value;
     }
-	
-    const std::size_t not_found = static_cast<std::size_t>(-1);
+
+    static constexpr std::size_t size = sizeof...(Cs);
+    static constexpr std::size_t not_found = static_cast<std::size_t>(-1);
 };
 
 } // namespace Saturn
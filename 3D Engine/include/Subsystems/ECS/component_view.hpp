@@ -1,28 +1,75 @@
 #ifndef MVG_COMPONENT_VIEW_HPP_
 #define MVG_COMPONENT_VIEW_HPP_
 
-#include "Subsystems/Scene/SceneObject.hpp"
+#include "Subsystems/JobSystem/JobSystem.hpp"
+#include "component_container.hpp"
 #include "component_index.hpp"
 
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace Saturn {
 
+namespace detail {
+
+// Changed or Added filter on a component pool
+struct tick_filter {
+    component_container_interface const* pool;
+    std::uint32_t since;
+    bool added;
+
+    bool matches(std::size_t entity) const {
+        auto const* ticks = pool->find_ticks(entity);
+        if (!ticks) { return false; }
+        return tick_newer(added ? ticks->added : ticks->changed, since);
+    }
+};
+
+} // namespace detail
+
+// View over all entities that have every component in Cs. Iteration is driven
+// by the smallest component pool among Cs; the other pools are only probed for
+// the entities found there. This means the cost of iterating a view scales
+// with the number of entities in the smallest pool instead of with the total
+// amount of objects in the scene.
+//
+// Components in Cs may be const qualified. Accessing a non-const component
+// through the view stamps its changed tick with the tick the view was
+// created with.
 template<typename... Cs>
 class component_view {
 public:
-    using entity_iterator = std::vector<std::unique_ptr<SceneObject>>::iterator;
-
-    // Warning: pass view of ENTITIES here!
-    component_view(entity_iterator e_first, entity_iterator e_last) :
-        first(e_first), last(e_last) {}
+    using pool_tuple =
+        std::tuple<component_container<std::remove_const_t<Cs>>*...>;
+
+    explicit component_view(
+        std::uint32_t tick,
+        component_container<std::remove_const_t<Cs>>*... pools) :
+        pools(pools...),
+        tick(tick) {
+        driver = smallest_pool(std::index_sequence_for<Cs...>{});
+    }
+
+    // Most filters a view can take. They are stored in the view, so creating
+    // a filtered view does not allocate.
+    static constexpr std::size_t max_filters = 4;
+
+    // Only yield entities that also pass filter
+    void add_filter(detail::tick_filter filter) {
+        assert(filter_count < max_filters && "Too many filters");
+        filters[filter_count++] = filter;
+    }
 
     class iterator {
     public:
         iterator() = default;
-        iterator(entity_iterator i, entity_iterator end) : it(i), last(end) {
-            if (it == last) stop = true;
-            ensure_valid_iterator();
+        iterator(component_view* v, std::size_t p) : view(v), pos(p) {
+            skip_unmatched();
         }
         iterator(iterator const&) = default;
         iterator(iterator&&) = default;
@@ -30,38 +77,14 @@ public:
         iterator& operator=(iterator const&) = default;
         iterator& operator=(iterator&&) = default;
 
-        std::tuple<Cs&...> operator*() {
-            if (stop) {
-                throw std::runtime_error(
-                    "Attempting to dereference an invalid iterator");
-            }
-            return std::tie((*it)->template get_component<Cs>()...);
-        }
-
-        std::tuple<Cs const&...> operator*() const {
-            if (stop) {
-                throw std::runtime_error(
-                    "Attempting to dereference an invalid iterator");
-            }
-            return std::tie((*it)->template get_component<Cs>()...)
+        std::tuple<Cs&...> operator*() const {
+            return view->get(pos, std::index_sequence_for<Cs...>{});
         }
 
         // prefix increment
         iterator& operator++() {
-            if (stop) { return *this; }
-
-            if (it == last) { //#MaybeOptimize Is this check redundant?
-                stop = true;
-                return *this;
-            }
-
-            ++it;
-
-            if (it == last) {
-                stop = true;
-                return *this;
-            }
-            if (!((*it)->template has_component<Cs>() && ...)) { ++(*this); }
+            ++pos;
+            skip_unmatched();
             return *this;
         }
 
@@ -71,32 +94,122 @@ public:
             return copy;
         }
 
-        bool operator==(iterator const& rhs) {
-            if (last == rhs.last && rhs.it == rhs.last) return it == rhs.it;
-            if (stop == false && rhs.stop == false) return true;
-            return *it == *rhs.it;
-        }
-
-        bool operator!=(iterator const& rhs) { return !(*this == rhs); }
+        bool operator==(iterator const& rhs) const { return pos == rhs.pos; }
+        bool operator!=(iterator const& rhs) const { return !(*this == rhs); }
 
     private:
-        void ensure_valid_iterator() {
-            if (stop || it == last) return;
-            while (it != last && !((*it)->template has_component<Cs>() && ...)) { ++(*this); }
+        // Advances until pos points to an entity that has all components, or
+        // until the end of the driving pool is reached
+        void skip_unmatched() {
+            auto const last = view->driver_size();
+            while (pos < last && !view->matches(pos)) { ++pos; }
         }
 
-        entity_iterator it;
-        entity_iterator last;
-
-        bool stop = false;
+        component_view* view = nullptr;
+        std::size_t pos = 0;
     };
 
-    iterator begin() { return iterator{first, last}; }
-    iterator end() { return iterator{last, last}; }
+    iterator begin() { return iterator{this, 0}; }
+    iterator end() { return iterator{this, driver_size()}; }
+
+    // Upper bound for the amount of entities this view will yield
+    std::size_t size_hint() const { return driver_size(); }
+
+    // Calls fn(Cs&...) for every matching entity. The driving pool is split
+    // into ranges of grain_size components that are processed on the job
+    // system, so every entity is visited exactly once. fn must not add or
+    // remove components.
+    template<typename F>
+    void parallel_for_each(F&& fn, std::size_t grain_size = 1024) {
+        JobSystem::parallel_for(
+            driver_size(), grain_size,
+            [this, &fn](std::size_t begin, std::size_t end) {
+                for (auto pos = begin; pos != end; ++pos) {
+                    if (!matches(pos)) { continue; }
+                    std::apply(fn, get(pos, std::index_sequence_for<Cs...>{}));
+                }
+            });
+    }
 
 private:
-    entity_iterator first;
-    entity_iterator last;
+    template<std::size_t... Is>
+    std::size_t smallest_pool(std::index_sequence<Is...>) const {
+        std::size_t result = 0;
+        std::size_t smallest = static_cast<std::size_t>(-1);
+        ((std::get<Is>(pools)->size() < smallest
+              ? (void)(smallest = std::get<Is>(pools)->size(), result = Is)
+              : (void)0),
+         ...);
+        return result;
+    }
+
+    std::size_t driver_size() const {
+        return driver_size_impl(std::index_sequence_for<Cs...>{});
+    }
+
+    template<std::size_t... Is>
+    std::size_t driver_size_impl(std::index_sequence<Is...>) const {
+        std::size_t result = 0;
+        ((driver == Is ? (void)(result = std::get<Is>(pools)->size())
+                       : (void)0),
+         ...);
+        return result;
+    }
+
+    // Returns the index of the entity owning the component at index pos in
+    // the driving pool
+    std::size_t entity_at(std::size_t pos) const {
+        return entity_at_impl(pos, std::index_sequence_for<Cs...>{});
+    }
+
+    template<std::size_t... Is>
+    std::size_t entity_at_impl(std::size_t pos,
+                               std::index_sequence<Is...>) const {
+        std::size_t result = 0;
+        ((driver == Is ? (void)(result = (std::get<Is>(pools)->begin() + pos)
+                                             ->entity.index)
+                       : (void)0),
+         ...);
+        return result;
+    }
+
+    bool matches(std::size_t pos) const {
+        auto const entity = entity_at(pos);
+        if (!(std::get<component_container<std::remove_const_t<Cs>>*>(pools)
+                  ->contains(entity) &&
+              ...)) {
+            return false;
+        }
+        for (std::size_t i = 0; i < filter_count; ++i) {
+            if (!filters[i].matches(entity)) { return false; }
+        }
+        return true;
+    }
+
+    template<std::size_t I, typename C>
+    C& get_one(std::size_t pos, std::size_t entity) {
+        auto* pool = std::get<I>(pools);
+        // The driving pool is indexed directly, the others are probed by
+        // entity index
+        if (driver != I) { pos = pool->index_of(entity); }
+        if constexpr (!std::is_const_v<C>) {
+            pool->ticks_at(pos).changed = tick;
+        }
+        return *(pool->begin() + pos);
+    }
+
+    template<std::size_t... Is>
+    std::tuple<Cs&...> get(std::size_t pos, std::index_sequence<Is...>) {
+        auto const entity = entity_at(pos);
+        return std::tuple<Cs&...>(get_one<Is, Cs>(pos, entity)...);
+    }
+
+    pool_tuple pools;
+    // Index in Cs of the pool that drives iteration
+    std::size_t driver = 0;
+    std::uint32_t tick;
+    std::array<detail::tick_filter, max_filters> filters{};
+    std::size_t filter_count = 0;
 };
 
 } // namespace Saturn
@@ -0,0 +1,158 @@
+#ifndef MVG_ECS_SNAPSHOT_HPP_
+#define MVG_ECS_SNAPSHOT_HPP_
+
+#include "Entity.hpp"
+#include "change_tick.hpp"
+#include "sparse_page_table.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <vector>
+
+namespace Saturn {
+
+// Copy of all components of an ECS, taken by ECS::capture at a sync point
+// where no systems run. A snapshot does not point into the ECS, so other
+// threads can read it without locks while the ECS keeps changing. Capturing
+// into a snapshot again reuses its memory.
+//
+// Components are copied with one range copy per component container (or per
+// archetype chunk with the archetype backend). For trivially copyable
+// components this is a plain memmove. Components holding resources or vectors
+// are copied element by element.
+template<typename... Cs>
+class ecs_snapshot {
+public:
+    // All captured components of type C, in storage order
+    template<typename C>
+    class component_set {
+    public:
+        using const_iterator = typename std::vector<C>::const_iterator;
+
+        const_iterator begin() const { return components.begin(); }
+        const_iterator end() const { return components.end(); }
+        std::size_t size() const { return components.size(); }
+        bool empty() const { return components.empty(); }
+
+        // Returns the component owned by entity, or nullptr if it had none
+        C const* find(Entity entity) const {
+            auto const idx = index.get(entity.index);
+            if (idx == invalid_index) { return nullptr; }
+            auto const& component = components[idx];
+            return component.entity == entity ? &component : nullptr;
+        }
+
+        bool contains(Entity entity) const { return find(entity) != nullptr; }
+
+        C const& get(Entity entity) const {
+            auto const* component = find(entity);
+            assert(component && "Entity had no component of this type");
+            return *component;
+        }
+
+        // Change ticks of the component owned by entity, or nullptr if it
+        // had none
+        component_ticks const* find_ticks(Entity entity) const {
+            auto const* component = find(entity);
+            if (!component) { return nullptr; }
+            return &ticks[static_cast<std::size_t>(component - &components[0])];
+        }
+
+        // Change ticks of the component at position i. With the archetype
+        // backend these are the ticks of the chunk it was stored in.
+        component_ticks const& ticks_at(std::size_t i) const {
+            return ticks[i];
+        }
+
+        // Whether any component was added or changed after the tick since
+        bool any_changed(std::uint32_t since) const {
+            for (auto const& t : ticks) {
+                if (tick_newer(t.changed, since) ||
+                    tick_newer(t.added, since)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Capture functions, used by ECS::capture
+
+        // Copies a whole component_container, including its index
+        template<typename Container>
+        void assign(Container const& container) {
+            auto const* first = container.data();
+            components.assign(first, first + container.size());
+            auto const* first_ticks = container.ticks_data();
+            ticks.assign(first_ticks, first_ticks + container.size());
+            index = container.index_table();
+        }
+
+        void clear() {
+            // Reset the index through the stale entries, so its pages stay
+            // allocated
+            for (auto const& component : components) {
+                index.reset(component.entity.index);
+            }
+            components.clear();
+            ticks.clear();
+        }
+
+        // Appends count components that share the same ticks, like the rows
+        // of an archetype chunk
+        void append(C const* first,
+                    Entity const* owners,
+                    std::size_t count,
+                    component_ticks const& chunk_ticks) {
+            auto const offset = components.size();
+            components.insert(components.end(), first, first + count);
+            ticks.insert(ticks.end(), count, chunk_ticks);
+            for (std::size_t i = 0; i < count; ++i) {
+                index.slot(owners[i].index) = offset + i;
+            }
+        }
+
+    private:
+        static constexpr std::size_t invalid_index =
+            static_cast<std::size_t>(-1);
+
+        std::vector<C> components;
+        std::vector<component_ticks> ticks;
+        // Maps an entity index to its position in components
+        detail::sparse_page_table<std::size_t> index{invalid_index};
+    };
+
+    template<typename C>
+    component_set<C> const& components() const {
+        return std::get<component_set<C>>(sets);
+    }
+
+    template<typename C>
+    component_set<C>& components() {
+        return std::get<component_set<C>>(sets);
+    }
+
+    template<typename C>
+    bool has_component(Entity entity) const {
+        return components<C>().contains(entity);
+    }
+
+    template<typename C>
+    C const& get_component(Entity entity) const {
+        return components<C>().get(entity);
+    }
+
+    // Change tick at the time of the capture. Changes made to the ECS later
+    // are stamped with a newer tick.
+    std::uint32_t tick() const { return captured_tick; }
+    void set_tick(std::uint32_t tick) { captured_tick = tick; }
+
+private:
+    std::tuple<component_set<Cs>...> sets;
+    std::uint32_t captured_tick = 0;
+};
+
+} // namespace Saturn
+
+#endif
@@ -0,0 +1,201 @@
+#ifndef MVG_PERSISTENT_QUERY_HPP_
+#define MVG_PERSISTENT_QUERY_HPP_
+
+#include "Subsystems/JobSystem/JobSystem.hpp"
+#include "component_container.hpp"
+#include "sparse_page_table.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Saturn {
+
+namespace detail {
+
+// Interface the ECS uses to keep registered queries up to date without
+// knowing their component types
+class query_interface {
+public:
+    virtual ~query_interface() = 0;
+
+    // Called after the entity with this index gained a component the query
+    // matches on
+    virtual void on_component_added(std::size_t entity) = 0;
+    // Called after the entity with this index lost a component the query
+    // matches on
+    virtual void on_component_removed(std::size_t entity) = 0;
+    // Called after all components of the flagged entities were removed.
+    // dead is indexed by entity index.
+    virtual void on_entities_destroyed(std::vector<bool> const& dead) = 0;
+};
+
+} // namespace detail
+
+// Query over all entities that have every component in Cs. Unlike
+// component_view, which searches the component pools every time it is
+// created, a persistent query is registered with the ECS once and keeps a
+// dense list of the matching entities. The ECS updates the list whenever a
+// component in Cs is added or removed, so iterating the query walks that list
+// without testing any entity that does not match.
+//
+// Like with component_view, components in Cs may be const qualified, and
+// accessing a non-const component stamps its changed tick with the current
+// change tick.
+template<typename... Cs>
+class persistent_query : public detail::query_interface {
+public:
+    template<typename C>
+    using pool_type = component_container<std::remove_const_t<C>>;
+
+    persistent_query(std::atomic<std::uint32_t> const* tick,
+                     pool_type<Cs>*... pools) :
+        pools(pools...),
+        tick(tick) {
+        add_existing(std::index_sequence_for<Cs...>{});
+    }
+
+    persistent_query(persistent_query const&) = delete;
+    persistent_query& operator=(persistent_query const&) = delete;
+
+    class iterator {
+    public:
+        iterator() = default;
+        iterator(persistent_query* q, std::size_t p) : query(q), pos(p) {}
+
+        std::tuple<Cs&...> operator*() const { return query->get(pos); }
+
+        // prefix increment
+        iterator& operator++() {
+            ++pos;
+            return *this;
+        }
+
+        iterator operator++(int) {
+            iterator copy = *this;
+            ++(*this);
+            return copy;
+        }
+
+        bool operator==(iterator const& rhs) const { return pos == rhs.pos; }
+        bool operator!=(iterator const& rhs) const { return !(*this == rhs); }
+
+    private:
+        persistent_query* query = nullptr;
+        std::size_t pos = 0;
+    };
+
+    iterator begin() { return iterator{this, 0}; }
+    iterator end() { return iterator{this, members.size()}; }
+
+    // Exact amount of entities this query will yield
+    std::size_t size() const { return members.size(); }
+
+    // Calls fn(Cs&...) for every matching entity. The member list is split
+    // into ranges of grain_size entities that are processed on the job
+    // system. fn must not add or remove components.
+    template<typename F>
+    void parallel_for_each(F&& fn, std::size_t grain_size = 1024) {
+        JobSystem::parallel_for(
+            members.size(), grain_size,
+            [this, &fn](std::size_t begin, std::size_t end) {
+                for (auto pos = begin; pos != end; ++pos) {
+                    std::apply(fn, get(pos));
+                }
+            });
+    }
+
+    void on_component_added(std::size_t entity) override { try_add(entity); }
+
+    void on_component_removed(std::size_t entity) override {
+        if (!member_index.contains(entity)) { return; }
+        // Swap and pop, like component_container::erase_component
+        auto const pos = member_index.get(entity);
+        auto const last = members.back();
+        members[pos] = last;
+        member_index.slot(last) = pos;
+        member_index.reset(entity);
+        members.pop_back();
+    }
+
+    void on_entities_destroyed(std::vector<bool> const& dead) override {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < members.size(); ++i) {
+            auto const entity = members[i];
+            if (entity < dead.size() && dead[entity]) {
+                member_index.reset(entity);
+                continue;
+            }
+            if (kept != i) {
+                members[kept] = entity;
+                member_index.slot(entity) = kept;
+            }
+            ++kept;
+        }
+        members.resize(kept);
+    }
+
+private:
+    // Adds every entity that already matches, by walking the smallest pool
+    template<std::size_t... Is>
+    void add_existing(std::index_sequence<Is...>) {
+        std::size_t smallest = 0;
+        std::size_t smallest_size = static_cast<std::size_t>(-1);
+        ((std::get<Is>(pools)->size() < smallest_size
+              ? (void)(smallest_size = std::get<Is>(pools)->size(),
+                       smallest = Is)
+              : (void)0),
+         ...);
+        members.reserve(smallest_size);
+        ((smallest == Is ? add_from(*std::get<Is>(pools)) : void()), ...);
+    }
+
+    template<typename Pool>
+    void add_from(Pool const& pool) {
+        for (auto const& component : pool) {
+            try_add(static_cast<std::size_t>(component.entity.index));
+        }
+    }
+
+    void try_add(std::size_t entity) {
+        if (member_index.contains(entity)) { return; }
+        if (!(std::get<pool_type<Cs>*>(pools)->contains(entity) && ...)) {
+            return;
+        }
+        member_index.slot(entity) = members.size();
+        members.push_back(entity);
+    }
+
+    std::tuple<Cs&...> get(std::size_t pos) {
+        auto const entity = members[pos];
+        auto const now = tick->load(std::memory_order_relaxed);
+        return std::tuple<Cs&...>(get_one<Cs>(entity, now)...);
+    }
+
+    template<typename C>
+    C& get_one(std::size_t entity, std::uint32_t now) {
+        auto* pool = std::get<pool_type<C>*>(pools);
+        auto const index = pool->index_of(entity);
+        if constexpr (!std::is_const_v<C>) {
+            pool->ticks_at(index).changed = now;
+        }
+        return *(pool->begin() + index);
+    }
+
+    static constexpr std::size_t invalid_index = static_cast<std::size_t>(-1);
+
+    std::tuple<pool_type<Cs>*...> pools;
+    std::atomic<std::uint32_t> const* tick;
+    // Indices of the matching entities
+    std::vector<std::size_t> members;
+    // Position of each matching entity in members, by entity index
+    detail::sparse_page_table<std::size_t> member_index{invalid_index};
+};
+
+} // namespace Saturn
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef MVG_SNAPSHOT_BUFFER_HPP_
+#define MVG_SNAPSHOT_BUFFER_HPP_
+
+#include <array>
+#include <atomic>
+#include <thread>
+
+namespace Saturn {
+
+// Double buffer for snapshots. One writer thread fills the back buffer at a
+// sync point and publishes it. Any amount of readers take the latest published
+// snapshot without locks, and keep it alive until their read_handle is
+// destroyed.
+//
+// A buffer is only written again once all of its readers are done, so the
+// writer waits if a reader still holds a snapshot from two publishes ago.
+// Readers are expected to hold handles for about a frame at most.
+template<typename T>
+class snapshot_buffer {
+    struct slot {
+        T value;
+        std::atomic<int> readers{0};
+    };
+
+public:
+    class read_handle {
+    public:
+        read_handle() = default;
+        read_handle(read_handle const&) = delete;
+        read_handle(read_handle&& rhs) noexcept : held(rhs.held) {
+            rhs.held = nullptr;
+        }
+
+        read_handle& operator=(read_handle const&) = delete;
+        read_handle& operator=(read_handle&& rhs) noexcept {
+            release();
+            held = rhs.held;
+            rhs.held = nullptr;
+            return *this;
+        }
+
+        ~read_handle() { release(); }
+
+        // False if nothing was published yet
+        bool valid() const { return held != nullptr; }
+
+        T const& operator*() const { return held->value; }
+        T const* operator->() const { return &held->value; }
+
+    private:
+        friend class snapshot_buffer;
+        explicit read_handle(slot* s) : held(s) {}
+
+        void release() {
+            if (held) { held->readers.fetch_sub(1); }
+            held = nullptr;
+        }
+
+        slot* held = nullptr;
+    };
+
+    // Calls write(back) on the buffer that is not published, then publishes
+    // it. Must only be called from one thread at a time.
+    template<typename F>
+    void publish(F&& write) {
+        auto* front = published.load();
+        auto* back = front == &slots[0] ? &slots[1] : &slots[0];
+        // Readers that took back before the last publish may still use it
+        while (back->readers.load() != 0) { std::this_thread::yield(); }
+        write(back->value);
+        published.store(back);
+    }
+
+    // Returns the latest published snapshot. Never blocks.
+    read_handle acquire() {
+        while (true) {
+            auto* s = published.load();
+            if (!s) { return read_handle{}; }
+            s->readers.fetch_add(1);
+            // If the slot is still published, publish can not pick it as the
+            // back buffer before this reader is done with it
+            if (published.load() == s) { return read_handle{s}; }
+            s->readers.fetch_sub(1);
+        }
+    }
+
+private:
+    std::array<slot, 2> slots;
+    std::atomic<slot*> published{nullptr};
+};
+
+} // namespace Saturn
+
+#endif
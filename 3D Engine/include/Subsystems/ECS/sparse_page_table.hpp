@@ -0,0 +1,53 @@
+#ifndef MVG_SPARSE_PAGE_TABLE_HPP_
+#define MVG_SPARSE_PAGE_TABLE_HPP_
+
+#include <cstddef>
+#include <vector>
+
+namespace Saturn::detail {
+
+// Paged sparse array mapping ids to values. A page is only allocated once an
+// id in its range is written to, so large or sparse ids do not cost memory for
+// the unused ranges. Lookups are two array indexings.
+template<typename T>
+class sparse_page_table {
+public:
+    // Number of ids per page. Power of two, so the divisions below compile to
+    // shifts and masks.
+    static constexpr std::size_t page_size = 4096;
+
+    explicit sparse_page_table(T empty = T{}) : empty_value(empty) {}
+
+    // Returns the value stored for this id, or the empty value if there is
+    // none
+    T const& get(std::size_t id) const {
+        auto page = id / page_size;
+        if (page >= pages.size() || pages[page].empty()) { return empty_value; }
+        return pages[page][id % page_size];
+    }
+
+    bool contains(std::size_t id) const { return get(id) != empty_value; }
+
+    // Returns the slot for this id, allocating its page if needed
+    T& slot(std::size_t id) {
+        auto page = id / page_size;
+        if (page >= pages.size()) { pages.resize(page + 1); }
+        if (pages[page].empty()) { pages[page].resize(page_size, empty_value); }
+        return pages[page][id % page_size];
+    }
+
+    void reset(std::size_t id) {
+        auto page = id / page_size;
+        if (page < pages.size() && !pages[page].empty()) {
+            pages[page][id % page_size] = empty_value;
+        }
+    }
+
+private:
+    T empty_value;
+    std::vector<std::vector<T>> pages;
+};
+
+} // namespace Saturn::detail
+
+#endif
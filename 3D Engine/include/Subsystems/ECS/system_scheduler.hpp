@@ -0,0 +1,172 @@
+#ifndef MVG_SYSTEM_SCHEDULER_HPP_
+#define MVG_SYSTEM_SCHEDULER_HPP_
+
+#include "Systems/SystemBase.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace Saturn {
+
+// Runs the systems of an ECS each frame. Systems are ordered in a dependency
+// graph built from their declared component access: a system depends on every
+// earlier registered system it conflicts with. In parallel mode systems whose
+// dependencies have finished are scheduled as jobs on the JobSystem, so
+// systems touching disjoint components run concurrently. In sequential mode
+// systems run one after another in registration order, which is a valid
+// order for the same graph and gives the same results.
+//
+// After a system has run, the change tick is advanced and its old value is
+// stored as the system's last run tick.
+//
+// Systems belong to either the variable update, which runs once per frame, or
+// the fixed update, which runs once per fixed timestep. Each run executes the
+// systems of one stage; dependencies only exist between systems of the same
+// stage.
+class system_scheduler {
+public:
+    enum class mode { parallel, sequential };
+    enum class update_stage { variable, fixed };
+
+    // Component access of a system, as bitmasks indexed like the component
+    // list of the ECS
+    struct system_access {
+        std::uint64_t reads = 0;
+        std::uint64_t writes = 0;
+        // Conflicts with every other system
+        bool exclusive = true;
+        bool main_thread_only = false;
+        update_stage stage = update_stage::variable;
+    };
+
+    system_scheduler() = default;
+    system_scheduler(system_scheduler const&) = delete;
+    system_scheduler& operator=(system_scheduler const&) = delete;
+
+    void add_system(Systems::SystemBase* system, system_access access);
+
+    void set_mode(mode m);
+    mode get_mode() const;
+
+    // Runs the systems of the given stage
+    void run(Scene& scene,
+             std::atomic<std::uint32_t>& tick,
+             update_stage stage = update_stage::variable);
+
+    // Amount of systems in the given stage
+    std::size_t system_count(update_stage stage) const;
+
+private:
+    struct node {
+        Systems::SystemBase* system;
+        system_access access;
+        // Indices of systems that have to wait for this one
+        std::vector<std::size_t> dependents;
+        std::size_t dependency_count = 0;
+    };
+
+    static bool conflicts(system_access const& a, system_access const& b);
+
+    void run_sequential(Scene& scene);
+    void run_parallel(Scene& scene);
+    void run_system(Systems::SystemBase& system, Scene& scene);
+
+    // Runs a system and marks it as finished. Expects the lock to be held
+    // and releases it while the system is running.
+    void execute(std::size_t index, std::unique_lock<std::mutex>& lock);
+    void push_ready(std::size_t index);
+
+    std::vector<node> nodes;
+    mode current_mode = mode::parallel;
+
+    std::mutex mutex;
+    // Notified whenever a system finishes
+    std::condition_variable wake;
+
+    // State of the frame being run. Protected by mutex
+    Scene* frame_scene = nullptr;
+    std::atomic<std::uint32_t>* frame_tick = nullptr;
+    update_stage frame_stage = update_stage::variable;
+    std::vector<std::size_t> pending_dependencies;
+    std::deque<std::size_t> ready_main_thread;
+    std::size_t finished = 0;
+    std::exception_ptr error;
+};
+
+namespace detail {
+
+template<typename S, typename = void>
+struct system_reads {
+    static constexpr bool declared = false;
+    using type = Systems::access<>;
+};
+
+template<typename S>
+struct system_reads<S, std::void_t<typename S::reads>> {
+    static constexpr bool declared = true;
+    using type = typename S::reads;
+};
+
+template<typename S, typename = void>
+struct system_writes {
+    static constexpr bool declared = false;
+    using type = Systems::access<>;
+};
+
+template<typename S>
+struct system_writes<S, std::void_t<typename S::writes>> {
+    static constexpr bool declared = true;
+    using type = typename S::writes;
+};
+
+template<typename S, typename = void>
+struct system_main_thread_only : std::false_type {};
+
+template<typename S>
+struct system_main_thread_only<S,
+                               std::void_t<decltype(S::main_thread_only)>> :
+    std::bool_constant<S::main_thread_only> {};
+
+template<typename S, typename = void>
+struct system_fixed_update : std::false_type {};
+
+template<typename S>
+struct system_fixed_update<S, std::void_t<decltype(S::fixed_update)>> :
+    std::bool_constant<S::fixed_update> {};
+
+template<typename Table, typename... Cs>
+constexpr std::uint64_t access_mask(Systems::access<Cs...>) {
+    static_assert(((Table::template get<Cs>() != Table::not_found) && ...),
+                  "System accesses a component type that is not in the ECS");
+    return ((std::uint64_t(1) << Table::template get<Cs>()) | ... |
+            std::uint64_t(0));
+}
+
+// Builds the access masks for system S from its reads/writes declarations
+template<typename S, typename Table>
+system_scheduler::system_access make_system_access() {
+    using reads = system_reads<S>;
+    using writes = system_writes<S>;
+    system_scheduler::system_access result;
+    result.reads = access_mask<Table>(typename reads::type{});
+    result.writes = access_mask<Table>(typename writes::type{});
+    result.exclusive = !reads::declared && !writes::declared;
+    result.main_thread_only = system_main_thread_only<S>::value;
+    result.stage = system_fixed_update<S>::value
+                       ? system_scheduler::update_stage::fixed
+                       : system_scheduler::update_stage::variable;
+    return result;
+}
+
+} // namespace detail
+
+} // namespace Saturn
+
+#endif
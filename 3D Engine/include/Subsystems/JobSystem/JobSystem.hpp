@@ -0,0 +1,116 @@
+#ifndef MVG_JOB_SYSTEM_HPP_
+#define MVG_JOB_SYSTEM_HPP_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace Saturn {
+
+namespace detail {
+struct Job;
+
+// Non-owning reference to the function of a parallel_for call. Unlike
+// std::function it never allocates.
+struct RangeCallback {
+    void* fn;
+    void (*call)(void* fn, std::size_t begin, std::size_t end);
+};
+} // namespace detail
+
+// Handle to a scheduled job. Handles are cheap to copy and keep the job's
+// state alive, so they may outlive the job itself.
+class JobHandle {
+public:
+    JobHandle() = default;
+
+    // Whether this handle refers to a job
+    bool valid() const;
+    // Whether the job has finished, or was skipped because one of its
+    // dependencies threw
+    bool done() const;
+
+private:
+    friend class JobSystem;
+
+    explicit JobHandle(std::shared_ptr<detail::Job> job);
+
+    std::shared_ptr<detail::Job> job;
+};
+
+// Engine wide pool of worker threads. Every worker has its own job queue.
+// Jobs scheduled from a worker go to the back of its queue and the worker
+// takes its next job from there, so related work stays on one thread. Idle
+// workers steal from the front of other workers' queues. Jobs scheduled from
+// other threads go to a shared queue.
+//
+// Threads that wait for a job run other queued jobs in the meantime, so
+// waiting from inside a job does not block a worker. Before initialize is
+// called, or with no worker threads, jobs only run inside wait on the waiting
+// thread.
+class JobSystem {
+public:
+    using Function = std::function<void()>;
+
+    // Starts one worker thread less than the hardware thread count, because
+    // the main thread takes part in waits
+    static void initialize();
+    static void initialize(std::size_t worker_count);
+    // Runs all queued jobs to completion and joins the worker threads. Done
+    // automatically at program exit. Neither initialize nor shutdown may be
+    // called while jobs are running.
+    static void shutdown();
+
+    // Amount of worker threads, not counting the threads that wait for jobs
+    static std::size_t worker_count();
+
+    static JobHandle schedule(Function fn);
+    // Runs fn once all dependencies are done. Invalid handles are ignored.
+    // If a dependency throws, fn is skipped and the exception is passed on
+    // to this job.
+    static JobHandle schedule(Function fn,
+                              std::vector<JobHandle> const& dependencies);
+    // Continuation of a single job
+    static JobHandle then(JobHandle const& dependency, Function fn);
+
+    // Blocks until the job is done and rethrows the exception it or one of
+    // its dependencies threw. Runs other queued jobs while waiting.
+    static void wait(JobHandle const& job);
+    static void wait(std::vector<JobHandle> const& jobs);
+
+    // Runs one queued job on the calling thread. Returns false if there was
+    // none. Lets threads that wait for something other than a job help out.
+    static bool run_pending_job();
+
+    // Calls fn(begin, end) for consecutive ranges of at most grain_size
+    // indices that together cover [0, count) exactly once. Blocks until all
+    // ranges are done. The calling thread processes ranges as well, so this
+    // may be called from inside a job. The first exception thrown by fn is
+    // rethrown on the calling thread.
+    //
+    // The helper jobs are reused by later calls on the same thread, so once
+    // a thread has run a loop with as many helpers, loops do not allocate.
+    template<typename F>
+    static void parallel_for(std::size_t count,
+                             std::size_t grain_size,
+                             F&& fn) {
+        using Fn = std::remove_reference_t<F>;
+        run_parallel_for(
+            count, grain_size,
+            {const_cast<void*>(static_cast<void const*>(&fn)),
+             [](void* f, std::size_t begin, std::size_t end) {
+                 (*static_cast<Fn*>(f))(begin, end);
+             }});
+    }
+
+private:
+    static void run_parallel_for(std::size_t count,
+                                 std::size_t grain_size,
+                                 detail::RangeCallback fn);
+};
+
+} // namespace Saturn
+
+#endif
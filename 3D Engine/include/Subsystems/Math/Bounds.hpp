@@ -0,0 +1,83 @@
+#ifndef MVG_BOUNDS_HPP_
+#define MVG_BOUNDS_HPP_
+
+#include "Transform.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Saturn::Math {
+
+struct AABB {
+    glm::vec3 min{0.0f, 0.0f, 0.0f};
+    glm::vec3 max{0.0f, 0.0f, 0.0f};
+};
+
+struct BoundingSphere {
+    glm::vec3 center{0.0f, 0.0f, 0.0f};
+    float radius = 0.0f;
+};
+
+// Describes where the positions are in an interleaved vertex buffer. All
+// values are counted in floats.
+struct PositionLayout {
+    std::size_t stride;
+    std::size_t offset;
+    // Missing components are 0. Must be 1, 2 or 3
+    std::size_t components = 3;
+};
+
+// Bounds of the positions in vertices. Both are empty if there are no
+// vertices. The sphere is centered on the box, which keeps it tight for the
+// mostly box shaped meshes we have.
+AABB compute_aabb(std::vector<float> const& vertices,
+                  PositionLayout const& layout);
+BoundingSphere compute_bounding_sphere(std::vector<float> const& vertices,
+                                       PositionLayout const& layout,
+                                       AABB const& aabb);
+
+// Planes of a view volume as (normal, distance) with the normals pointing
+// inwards, in the order left, right, bottom, top, near, far
+struct Frustum {
+    std::array<glm::vec4, 6> planes;
+};
+
+// Extracts the planes from a projection * view matrix. The planes are in world
+// space and normalized.
+Frustum extract_frustum(glm::mat4 const& view_projection);
+
+// World space bounds of a batch of meshes, laid out like TransformLanes so
+// cull_bounds can test four of them with one instruction. Boxes are stored as
+// center and half extents.
+class BoundsLanes {
+public:
+    std::size_t size() const { return radius.size(); }
+    void reserve(std::size_t count);
+    void clear();
+
+    // Transforms local bounds by model to world space and appends them
+    void push_back(AABB const& aabb,
+                   BoundingSphere const& sphere,
+                   glm::mat4 const& model);
+
+    Vec3Lanes center;
+    Vec3Lanes extents;
+    Vec3Lanes sphere_center;
+    std::vector<float> radius;
+};
+
+// Appends the index of every bounds that is not completely outside the
+// frustum to visible, in increasing order. A mesh is outside if its box or its
+// sphere is behind one of the planes. On SSE2 capable targets four bounds are
+// tested at once.
+void cull_bounds(Frustum const& frustum,
+                 BoundsLanes const& bounds,
+                 std::vector<std::uint32_t>& visible);
+
+} // namespace Saturn::Math
+
+#endif
@@ -5,12 +5,14 @@
 
 namespace Saturn::Math {
 
+// base is a unit vector
 glm::vec3 random_direction(glm::vec3 const& base, float randomness);
-// base_rotation in euler angles
-glm::vec3 direction_in_sphere(float randomness, glm::vec3 const& base_rotation);
+// The generators below are centered around the y axis, which is rotated by
+// rotation (usually Transform::world_rotation)
+glm::vec3 direction_in_sphere(float randomness, glm::mat3 const& rotation);
 glm::vec3 direction_in_hemisphere(float randomness,
-                                  glm::vec3 base = {0.0f, 1.0f, 0.0f});
-glm::vec3 direction_in_cone(float arc, float angle, glm::vec3 const& rotation);
+                                  glm::mat3 const& rotation = glm::mat3(1.0f));
+glm::vec3 direction_in_cone(float arc, float angle, glm::mat3 const& rotation);
 
 }
 
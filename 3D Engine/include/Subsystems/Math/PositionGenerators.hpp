@@ -7,14 +7,15 @@ namespace Saturn::Math {
 
 glm::vec3 random_position(glm::vec3 const& base, float max_offset);
 glm::vec3 position_on_sphere(float radius);
-glm::vec3 position_on_hemisphere(float radius, glm::vec3 const& rotation);
+// rotation is usually Transform::world_rotation
+glm::vec3 position_on_hemisphere(float radius, glm::mat3 const& rotation);
 
 glm::vec3
-position_on_circle(float radius, float arc, glm::vec3 const& rotation);
+position_on_circle(float radius, float arc, glm::mat3 const& rotation);
 
 // scale specifies how to scale the box centered (0, 0, 0) with size(1, 1,
 // 1)
-glm::vec3 position_in_box(glm::vec3 const& scale, glm::vec3 const& rotation);
+glm::vec3 position_in_box(glm::vec3 const& scale, glm::mat3 const& rotation);
 
 } // namespace Saturn::Math
 
@@ -2,6 +2,10 @@
 #define MVG_TRANSFORM_HPP_
 
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <cstddef>
+#include <vector>
 
 namespace glm {
 
@@ -13,6 +17,65 @@ namespace Saturn::Math {
 
 glm::vec3 rotate_vector_by_quaternion(const glm::vec3& v, const glm::quat& q);
 
+// Conversions between rotations and euler angles in degrees, which are only
+// used for authoring and serialization. The euler rotation is applied around
+// x first, then y, then z.
+glm::quat euler_to_quat(glm::vec3 const& degrees);
+glm::vec3 quat_to_euler(glm::quat const& rotation);
+
+// One float lane per transform for each coordinate
+struct Vec3Lanes {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+};
+
+struct QuatLanes {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> w;
+};
+
+// Structure of arrays storage for a batch of transforms, laid out so that
+// compose_model_matrices can load the same coordinate of several transforms
+// with a single instruction. Rotations are normalized quaternions, like in
+// Components::Transform.
+class TransformLanes {
+public:
+    std::size_t size() const { return position.x.size(); }
+    void reserve(std::size_t count);
+    void resize(std::size_t count);
+    void clear();
+
+    void push_back(glm::vec3 const& pos,
+                   glm::quat const& rot,
+                   glm::vec3 const& scl);
+    void set(std::size_t index,
+             glm::vec3 const& pos,
+             glm::quat const& rot,
+             glm::vec3 const& scl);
+
+    glm::vec3 position_at(std::size_t index) const;
+    glm::quat rotation_at(std::size_t index) const;
+    glm::vec3 scale_at(std::size_t index) const;
+
+    Vec3Lanes position;
+    QuatLanes rotation;
+    Vec3Lanes scale;
+};
+
+// Builds the model matrix of every transform in lanes into matrices and its
+// rotation matrix into rotations. Both must have room for lanes.size()
+// elements. The model matrix of each transform equals
+//
+//     translate(mat4(1), position) * mat4_cast(rotation) * scale
+//
+// On SSE2 capable targets four transforms are processed at once.
+void compose_model_matrices(TransformLanes const& lanes,
+                            glm::mat4* matrices,
+                            glm::mat3* rotations);
+
 } // namespace Saturn::Math
 
 #endif
@@ -0,0 +1,31 @@
+#ifndef MVG_FRAME_CONTEXT_HPP_
+#define MVG_FRAME_CONTEXT_HPP_
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Saturn {
+
+// Data derived from a RenderFrame that more than one pass or view reads. The
+// renderer builds it once at the start of every frame and keeps it between
+// frames, so its vectors stop allocating once they are large enough.
+struct FrameContext {
+    struct View {
+        glm::mat4 projection;
+        glm::mat4 view;
+        glm::mat4 view_projection;
+    };
+
+    // Matrices of every view, in the order of RenderFrame::views
+    std::vector<View> views;
+    // Transforms world space to the clip space of the shadow casting light
+    glm::mat4 lightspace;
+    // Meshes inside the light volume, as indices into RenderFrame::meshes
+    std::vector<std::uint32_t> shadow_casters;
+};
+
+} // namespace Saturn
+
+#endif
@@ -44,6 +44,8 @@ private:
     void create_fbo();
     void create_rbo();
     void create_texture();
+    // Removes the objects from the GLStateCache before deleting them
+    void forget_objects();
 
 	static inline unsigned int currently_bound = 0;
 };
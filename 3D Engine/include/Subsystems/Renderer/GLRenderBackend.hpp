@@ -0,0 +1,60 @@
+#ifndef MVG_GL_RENDER_BACKEND_HPP_
+#define MVG_GL_RENDER_BACKEND_HPP_
+
+#include "RenderBackend.hpp"
+
+namespace Saturn {
+
+// Replays commands as OpenGL calls on the thread the context is current on.
+// State changes go through the GLStateCache, so shaders and vertex arrays stay
+// bound after a command and a stream that draws with one shader binds it once.
+class GLRenderBackend : public RenderBackend {
+public:
+    void bind_framebuffer(Framebuffer& framebuffer) override;
+    void unbind_framebuffer() override;
+    void bind_depth_map_framebuffer(DepthMap& depth_map) override;
+    void set_viewport(unsigned int x,
+                      unsigned int y,
+                      unsigned int w,
+                      unsigned int h) override;
+
+    void set_clear_color(glm::vec4 const& color) override;
+    void clear(unsigned int flags) override;
+    void enable(unsigned int capability) override;
+    void disable(unsigned int capability) override;
+    void cull_face(unsigned int face) override;
+    void blend_func(unsigned int source, unsigned int destination) override;
+
+    void active_texture(unsigned int unit) override;
+    void bind_texture(Texture& texture) override;
+    void unbind_texture(Texture& texture) override;
+    void bind_depth_texture(DepthMap& depth_map) override;
+    void unbind_depth_texture() override;
+    void bind_texture_2d(unsigned int handle) override;
+
+    void set_uniform(Shader& shader, int location, int value) override;
+    void set_uniform(Shader& shader, int location, float value) override;
+    void
+    set_uniform(Shader& shader, int location, glm::mat4 const& value) override;
+
+    void update_uniform_buffer(UniformBuffer& buffer,
+                               std::size_t byte_offset,
+                               void const* data,
+                               std::size_t size) override;
+    void update_vertex_buffer(VertexArray& vertices,
+                              std::size_t buffer_index,
+                              float const* data,
+                              std::size_t count) override;
+
+    void draw_elements(Shader& shader, VertexArray& vertices) override;
+    void draw_elements_instanced(Shader& shader,
+                                 VertexArray& vertices,
+                                 std::size_t instances) override;
+
+    // Unbinds the shader and vertex array left bound by the replay
+    void finish() override;
+};
+
+} // namespace Saturn
+
+#endif
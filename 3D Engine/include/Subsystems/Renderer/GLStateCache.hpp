@@ -0,0 +1,132 @@
+#ifndef MVG_GL_STATE_CACHE_HPP_
+#define MVG_GL_STATE_CACHE_HPP_
+
+#include "glad/glad.h"
+
+#include <array>
+#include <cstddef>
+
+namespace Saturn {
+
+// Shadow copy of the OpenGL bindings and fixed function state. Changes to the
+// value that is already set are filtered out, so the GL wrappers can bind what
+// they need without knowing what is bound. Nothing is known at first, so the
+// first change of every state reaches OpenGL.
+//
+// The cache only sees changes made through it. After changing state with raw
+// OpenGL calls, call invalidate(). Deleting an object through raw calls is
+// fine as long as the matching forget_ function is called.
+class GLStateCache {
+public:
+    // OpenGL entry points the cache forwards to. Tests can pass functions that
+    // record the calls instead of a context.
+    struct Functions {
+        void (*use_program)(GLuint program);
+        void (*bind_vertex_array)(GLuint vertex_array);
+        void (*active_texture)(GLenum unit);
+        void (*bind_texture)(GLenum target, GLuint texture);
+        void (*bind_buffer)(GLenum target, GLuint buffer);
+        void (*bind_buffer_base)(GLenum target, GLuint index, GLuint buffer);
+        void (*bind_framebuffer)(GLenum target, GLuint framebuffer);
+        void (*enable)(GLenum capability);
+        void (*disable)(GLenum capability);
+        void (*blend_func)(GLenum source, GLenum destination);
+        void (*cull_face)(GLenum face);
+        void (*depth_func)(GLenum func);
+    };
+
+    struct Stats {
+        // Calls passed on to OpenGL
+        std::size_t issued = 0;
+        // Calls that would not have changed anything
+        std::size_t filtered = 0;
+    };
+
+    static constexpr std::size_t MaxTextureUnits = 32;
+    static constexpr std::size_t MaxUniformBufferBindings = 36;
+
+    explicit GLStateCache(Functions const& functions);
+
+    // Functions that call the loaded OpenGL functions
+    static Functions gl_functions();
+    // Cache used by the GL wrappers. Only use it on the thread the context is
+    // current on, after the OpenGL functions are loaded.
+    static GLStateCache& get();
+
+    void use_program(GLuint program);
+    // Also forgets the element array buffer, which belongs to the vertex array
+    void bind_vertex_array(GLuint vertex_array);
+    void active_texture(GLenum unit);
+    // Binds to the active texture unit
+    void bind_texture(GLenum target, GLuint texture);
+    // Activates unit if needed and binds to it
+    void bind_texture(GLenum unit, GLenum target, GLuint texture);
+    void bind_buffer(GLenum target, GLuint buffer);
+    // Like glBindBufferBase, also binds buffer to the generic target
+    void bind_buffer_base(GLenum target, GLuint index, GLuint buffer);
+    // Binds both the draw and the read framebuffer
+    void bind_framebuffer(GLuint framebuffer);
+    void enable(GLenum capability);
+    void disable(GLenum capability);
+    void blend_func(GLenum source, GLenum destination);
+    void cull_face(GLenum face);
+    void depth_func(GLenum func);
+
+    // OpenGL resets the bindings of a deleted object to 0. The functions have
+    // to be called when deleting, since new objects may reuse the name.
+    void forget_program(GLuint program);
+    void forget_vertex_array(GLuint vertex_array);
+    void forget_texture(GLuint texture);
+    void forget_buffer(GLuint buffer);
+    void forget_framebuffer(GLuint framebuffer);
+
+    // Forgets all state, so the next change of everything reaches OpenGL
+    void invalidate();
+
+    Stats const& get_stats() const;
+    void reset_stats();
+
+private:
+    // Value of state that is not known
+    static constexpr GLuint Unknown = static_cast<GLuint>(-1);
+    // Capabilities and texture and buffer targets that are cached. Others
+    // are passed on every time.
+    static constexpr std::array<GLenum, 5> Capabilities = {
+        GL_BLEND, GL_CULL_FACE, GL_DEPTH_TEST, GL_FRAMEBUFFER_SRGB,
+        GL_STENCIL_TEST};
+    static constexpr std::array<GLenum, 3> TextureTargets = {
+        GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY};
+    static constexpr std::array<GLenum, 3> BufferTargets = {
+        GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER};
+
+    template<std::size_t N>
+    static std::size_t index_of(std::array<GLenum, N> const& values,
+                                GLenum value);
+    // Stores value in cached and returns true if it differs. Counts the call
+    // as issued or filtered.
+    bool change(GLuint& cached, GLuint value);
+    // Counts a call for state that is not cached
+    void pass_through();
+
+    Functions gl;
+    Stats stats;
+
+    GLuint program;
+    GLuint vertex_array;
+    GLuint framebuffer;
+    GLenum active_unit;
+    std::array<std::array<GLuint, TextureTargets.size()>, MaxTextureUnits>
+        textures;
+    std::array<GLuint, BufferTargets.size()> buffers;
+    std::array<GLuint, MaxUniformBufferBindings> uniform_buffers;
+    // Unknown, 0 for disabled or 1 for enabled
+    std::array<GLuint, Capabilities.size()> capabilities;
+    GLenum blend_source;
+    GLenum blend_destination;
+    GLenum culled_face;
+    GLenum depth_function;
+};
+
+} // namespace Saturn
+
+#endif
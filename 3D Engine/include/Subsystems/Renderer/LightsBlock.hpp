@@ -0,0 +1,57 @@
+#ifndef MVG_LIGHTS_BLOCK_HPP_
+#define MVG_LIGHTS_BLOCK_HPP_
+
+#include "RenderFrame.hpp"
+#include "Std140.hpp"
+
+#include <array>
+#include <cstddef>
+
+namespace Saturn {
+
+// CPU copy of the Lights uniform block of the lit shaders, so that all lights
+// are uploaded with one buffer update. The layouts mirror the GLSL
+// declarations member by member. Shader passes MaxLightsPerType to the
+// shaders as MAX_LIGHTS_PER_TYPE.
+class LightsBlock {
+public:
+    static constexpr std::size_t MaxLightsPerType = 15;
+
+    // ambient, diffuse, specular, position, intensity
+    static constexpr std140::Struct<5> PointLightLayout{
+        {std140::Vec3, std140::Vec3, std140::Vec3, std140::Vec3,
+         std140::Float}};
+    // ambient, diffuse, specular, direction
+    static constexpr std140::Struct<4> DirectionalLightLayout{
+        {std140::Vec3, std140::Vec3, std140::Vec3, std140::Vec3}};
+    // ambient, diffuse, specular, position, direction, intensity,
+    // inner_angle, outer_angle
+    static constexpr std140::Struct<8> SpotLightLayout{
+        {std140::Vec3, std140::Vec3, std140::Vec3, std140::Vec3, std140::Vec3,
+         std140::Float, std140::Float, std140::Float}};
+    // point_light_count, directional_light_count, spot_light_count,
+    // point_lights, directional_lights, spot_lights
+    static constexpr std140::Struct<6> Layout{
+        {std140::Int, std140::Int, std140::Int,
+         std140::array(PointLightLayout.type(), MaxLightsPerType),
+         std140::array(DirectionalLightLayout.type(), MaxLightsPerType),
+         std140::array(SpotLightLayout.type(), MaxLightsPerType)}};
+
+    // Writes the lights of frame in one pass. Lights past MaxLightsPerType
+    // of a type are dropped.
+    void assign(RenderFrame const& frame);
+
+    void const* data() const { return bytes.data(); }
+    std::size_t size() const { return bytes.size(); }
+
+private:
+    void write(std::size_t offset, int value);
+    void write(std::size_t offset, float value);
+    void write(std::size_t offset, glm::vec3 const& value);
+
+    std::array<unsigned char, Layout.size> bytes{};
+};
+
+} // namespace Saturn
+
+#endif
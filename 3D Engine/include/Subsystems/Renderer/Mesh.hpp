@@ -1,6 +1,7 @@
 #ifndef MVG_MESH_HPP_
 #define MVG_MESH_HPP_
 
+#include "Subsystems/Math/Bounds.hpp"
 #include "VertexArray.hpp"
 
 namespace Saturn {
@@ -25,8 +26,17 @@ public:
     // call .assign()
     VertexArray& get_vertices();
 
+    // Bounds of the vertex positions in model space, computed when the mesh
+    // is assigned
+    Math::AABB const& get_aabb() const;
+    Math::BoundingSphere const& get_bounding_sphere() const;
+
 private:
+    void compute_bounds(VertexArray::CreateInfo const& info);
+
     VertexArray vertices;
+    Math::AABB aabb;
+    Math::BoundingSphere bounding_sphere;
 };
 
 } // namespace Saturn
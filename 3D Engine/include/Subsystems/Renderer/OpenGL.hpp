@@ -4,12 +4,21 @@
 #include "glad/glad.h"
 #include <GLFW/glfw3.h>
 
+#include "GLStateCache.hpp"
+
 
 namespace Saturn {
 
+// Constructor tag that leaves the OpenGL objects uncreated, with id 0. For
+// code that only stores the objects' addresses and runs without a context,
+// like recording render commands in tests and benchmarks.
+struct Headless {};
+inline constexpr Headless headless{};
+
 class Vao {
 public:
     Vao();
+    explicit Vao(Headless) {}
     Vao(Vao const&) = delete;
     Vao(Vao&& rhs) = delete;
 
@@ -44,6 +53,7 @@ template<BufferTarget Target>
 class Vbo {
 public:
     Vbo() { glGenBuffers(1, &id); }
+    explicit Vbo(Headless) {}
     Vbo(Vbo const&) = delete;
     Vbo(Vbo&& rhs) = delete;
 
@@ -51,16 +61,21 @@ public:
     Vbo& operator=(Vbo&& rhs) = delete;
 
     ~Vbo() {
-        if (id != 0) { glDeleteBuffers(1, &id); }
+        if (id != 0) {
+            GLStateCache::get().forget_buffer(id);
+            glDeleteBuffers(1, &id);
+        }
     }
 
     GLuint id = 0;
     static constexpr inline BufferTarget target = Target;
 
     static void bind(Vbo& vbo) {
-        glBindBuffer(static_cast<GLenum>(Target), vbo.id);
+        GLStateCache::get().bind_buffer(static_cast<GLenum>(Target), vbo.id);
+    }
+    static void unbind() {
+        GLStateCache::get().bind_buffer(static_cast<GLenum>(Target), 0);
     }
-    static void unbind() { glBindBuffer(static_cast<GLenum>(Target), 0); }
 };
 
 using Ebo = Vbo<BufferTarget::ElementArrayBuffer>;
@@ -0,0 +1,77 @@
+#ifndef MVG_RENDER_BACKEND_HPP_
+#define MVG_RENDER_BACKEND_HPP_
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+
+namespace Saturn {
+
+class DepthMap;
+class Framebuffer;
+class Shader;
+class Texture;
+class UniformBuffer;
+class VertexArray;
+
+// Executes the commands of a RenderCommandList. GLRenderBackend issues them
+// as OpenGL calls. Other implementations can check recorded command streams
+// without a GPU.
+//
+// GL enums and bitfields are passed as plain unsigned ints so that this
+// header does not depend on OpenGL.
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = 0;
+
+    virtual void bind_framebuffer(Framebuffer& framebuffer) = 0;
+    virtual void unbind_framebuffer() = 0;
+    virtual void bind_depth_map_framebuffer(DepthMap& depth_map) = 0;
+    virtual void set_viewport(unsigned int x,
+                              unsigned int y,
+                              unsigned int w,
+                              unsigned int h) = 0;
+
+    virtual void set_clear_color(glm::vec4 const& color) = 0;
+    virtual void clear(unsigned int flags) = 0;
+    virtual void enable(unsigned int capability) = 0;
+    virtual void disable(unsigned int capability) = 0;
+    virtual void cull_face(unsigned int face) = 0;
+    virtual void blend_func(unsigned int source, unsigned int destination) = 0;
+
+    virtual void active_texture(unsigned int unit) = 0;
+    virtual void bind_texture(Texture& texture) = 0;
+    virtual void unbind_texture(Texture& texture) = 0;
+    virtual void bind_depth_texture(DepthMap& depth_map) = 0;
+    virtual void unbind_depth_texture() = 0;
+    // Binds a raw 2D texture handle to the active texture unit
+    virtual void bind_texture_2d(unsigned int handle) = 0;
+
+    virtual void set_uniform(Shader& shader, int location, int value) = 0;
+    virtual void set_uniform(Shader& shader, int location, float value) = 0;
+    virtual void
+    set_uniform(Shader& shader, int location, glm::mat4 const& value) = 0;
+
+    // data is only valid during the call
+    virtual void update_uniform_buffer(UniformBuffer& buffer,
+                                       std::size_t byte_offset,
+                                       void const* data,
+                                       std::size_t size) = 0;
+    virtual void update_vertex_buffer(VertexArray& vertices,
+                                      std::size_t buffer_index,
+                                      float const* data,
+                                      std::size_t count) = 0;
+
+    // Draws the indexed triangles of vertices with shader
+    virtual void draw_elements(Shader& shader, VertexArray& vertices) = 0;
+    virtual void draw_elements_instanced(Shader& shader,
+                                         VertexArray& vertices,
+                                         std::size_t instances) = 0;
+
+    // Called by RenderCommandList::replay after the last command
+    virtual void finish() = 0;
+};
+
+} // namespace Saturn
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef MVG_RENDER_COMMAND_LIST_HPP_
+#define MVG_RENDER_COMMAND_LIST_HPP_
+
+#include "RenderBackend.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace Saturn {
+
+class Viewport;
+
+// Recorded stream of rendering commands, replayed later by a RenderBackend.
+// Commands are packed into one byte buffer: an opcode followed by its
+// arguments, and for buffer updates the data to upload. Resetting keeps the
+// memory, so recording a frame into a reused list does not allocate once the
+// list has grown to the size of a frame.
+//
+// Recording does not call OpenGL and may happen on any thread, so several
+// threads can record into lists of their own and append them to one list
+// afterwards. Objects passed by reference are stored as pointers and have to
+// outlive the replay.
+class RenderCommandList {
+public:
+    // Removes all commands and keeps the memory
+    void reset();
+
+    bool empty() const;
+    std::size_t command_count() const;
+    std::size_t size_bytes() const;
+
+    // Copies the commands of other to the end of this list
+    void append(RenderCommandList const& other);
+
+    void bind_framebuffer(Framebuffer& framebuffer);
+    void unbind_framebuffer();
+    void bind_depth_map_framebuffer(DepthMap& depth_map);
+    void set_viewport(Viewport const& viewport);
+
+    void set_clear_color(glm::vec4 const& color);
+    void clear(unsigned int flags);
+    void enable(unsigned int capability);
+    void disable(unsigned int capability);
+    void cull_face(unsigned int face);
+    void blend_func(unsigned int source, unsigned int destination);
+
+    void active_texture(unsigned int unit);
+    void bind_texture(Texture& texture);
+    void unbind_texture(Texture& texture);
+    void bind_depth_texture(DepthMap& depth_map);
+    void unbind_depth_texture();
+    void bind_texture_2d(unsigned int handle);
+
+    void set_uniform(Shader& shader, int location, int value);
+    void set_uniform(Shader& shader, int location, float value);
+    void set_uniform(Shader& shader, int location, glm::mat4 const& value);
+
+    // Copies size bytes of data into the list
+    void update_uniform_buffer(UniformBuffer& buffer,
+                               std::size_t byte_offset,
+                               void const* data,
+                               std::size_t size);
+    template<typename T>
+    void update_uniform_buffer(UniformBuffer& buffer,
+                               std::size_t byte_offset,
+                               T const& value) {
+        update_uniform_buffer(buffer, byte_offset, &value, sizeof(T));
+    }
+    // Copies count floats of data into the list
+    void update_vertex_buffer(VertexArray& vertices,
+                              std::size_t buffer_index,
+                              float const* data,
+                              std::size_t count);
+
+    void draw_elements(Shader& shader, VertexArray& vertices);
+    void draw_elements_instanced(Shader& shader,
+                                 VertexArray& vertices,
+                                 std::size_t instances);
+
+    // Runs every command on backend, in recording order
+    void replay(RenderBackend& backend) const;
+
+private:
+    // Every command starts at a multiple of this, so the padding inside an
+    // appended list stays valid
+    static constexpr std::size_t CommandAlignment = alignof(std::uint32_t);
+
+    enum class Op : std::uint8_t {
+        BindFramebuffer,
+        UnbindFramebuffer,
+        BindDepthMapFramebuffer,
+        SetViewport,
+        SetClearColor,
+        Clear,
+        Enable,
+        Disable,
+        CullFace,
+        BlendFunc,
+        ActiveTexture,
+        BindTexture,
+        UnbindTexture,
+        BindDepthTexture,
+        UnbindDepthTexture,
+        BindTexture2D,
+        SetUniformInt,
+        SetUniformFloat,
+        SetUniformMat4,
+        UpdateUniformBuffer,
+        UpdateVertexBuffer,
+        DrawElements,
+        DrawElementsInstanced
+    };
+
+    void write_op(Op op);
+
+    // Arguments are copied byte-wise, so the buffer needs no alignment
+    template<typename T>
+    void write(T const& value) {
+        std::memcpy(grow(sizeof(T)), &value, sizeof(T));
+    }
+    void write_bytes(void const* src, std::size_t size);
+    // Makes room for size more bytes and returns where they start
+    std::byte* grow(std::size_t size) {
+        if (size > data.size() - used) { reallocate(used + size); }
+        auto* dst = data.data() + used;
+        used += size;
+        return dst;
+    }
+    void reallocate(std::size_t min_size);
+    // Pads the buffer so the next write starts at a multiple of alignment.
+    // The buffer itself is allocated with operator new, which aligns it for
+    // any fundamental type.
+    void align_to(std::size_t alignment);
+    static std::size_t aligned(std::size_t pos, std::size_t alignment);
+
+    template<typename T>
+    T read(std::size_t& pos) const {
+        T value;
+        std::memcpy(&value, data.data() + pos, sizeof(T));
+        pos += sizeof(T);
+        return value;
+    }
+
+    // Only the first used bytes hold commands. The rest is spare room, so
+    // writing does not go through the vector's bookkeeping.
+    std::vector<std::byte> data;
+    std::size_t used = 0;
+    std::size_t commands = 0;
+};
+
+} // namespace Saturn
+
+#endif
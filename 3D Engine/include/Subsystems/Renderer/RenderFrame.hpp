@@ -0,0 +1,96 @@
+#ifndef MVG_RENDER_FRAME_HPP_
+#define MVG_RENDER_FRAME_HPP_
+
+#include "Subsystems/ECS/Components/DirectionalLight.hpp"
+#include "Subsystems/ECS/Components/PointLight.hpp"
+#include "Subsystems/ECS/Components/SpotLight.hpp"
+#include "Subsystems/Math/Bounds.hpp"
+#include "Viewport.hpp"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Saturn {
+
+class Shader;
+class Texture;
+class VertexArray;
+
+// Everything the renderer needs to draw one frame, copied out of the scene by
+// Renderer::extract_frame. A frame does not point into the ECS, so it stays
+// valid while the scene simulates the next frame. Shaders, textures and vertex
+// arrays are owned by the AssetManager and outlive the frame.
+//
+// Frames are reused, so extracting into one keeps the memory of its vectors.
+struct RenderFrame {
+    struct View {
+        Viewport viewport;
+        glm::vec3 position;
+        glm::vec3 front;
+        glm::vec3 up;
+        float fov;
+    };
+
+    struct Mesh {
+        glm::mat4 model;
+        VertexArray* vertices;
+        bool face_cull;
+        // Meshes without a material are only drawn to the shadow map
+        bool has_material;
+        // Null if the material has no shader
+        Shader* shader;
+        bool lit;
+        // Only set for unlit materials with a shader
+        Texture* texture;
+        Texture* diffuse_map;
+        Texture* specular_map;
+        float shininess;
+    };
+
+    struct PointLight {
+        Components::PointLight light;
+        glm::vec3 position;
+    };
+
+    struct SpotLight {
+        Components::SpotLight light;
+        glm::vec3 position;
+    };
+
+    struct ParticleBatch {
+        VertexArray* vertices;
+        // Null if the emitter has no texture
+        Texture* texture;
+        bool additive;
+        std::size_t count;
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> sizes;
+        std::vector<glm::vec4> colors;
+    };
+
+    // Viewport the frame is copied to the screen in
+    Viewport screen;
+    std::vector<View> views;
+    std::vector<Mesh> meshes;
+    // World space bounds of every mesh, in the same order as meshes
+    Math::BoundsLanes bounds;
+    std::vector<PointLight> point_lights;
+    std::vector<Components::DirectionalLight> directional_lights;
+    std::vector<SpotLight> spot_lights;
+    // Whether the light data has to be uploaded again
+    bool lights_changed = false;
+    // ECS change tick and amount of point, directional and spot lights at the
+    // previous extraction into this frame. lights_changed is computed against
+    // them, so extracting does not depend on state in the renderer.
+    std::uint32_t extracted_tick = 0;
+    std::array<std::size_t, 3> light_counts{};
+    std::vector<ParticleBatch> particles;
+};
+
+} // namespace Saturn
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef MVG_RENDER_QUEUE_HPP_
+#define MVG_RENDER_QUEUE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Saturn {
+
+// Draws of one pass, sorted by a packed 64 bit key so that draws sharing
+// state end up next to each other. From the most to the least significant
+// bits a key holds
+//
+//     pass (4) | shader (12) | material (20) | mesh (12) | depth (16)
+//
+// Ids that do not fit their field wrap around. That only makes the sort less
+// effective, because submission compares the actual state of neighbouring
+// draws to decide which state changes to record.
+class RenderQueue {
+public:
+    enum class Pass : std::uint8_t { Shadow = 0, Opaque = 1 };
+
+    struct Item {
+        std::uint64_t key;
+        // Index of the draw in the frame
+        std::uint32_t index;
+    };
+
+    // State changes recorded while submitting sorted draws
+    struct Stats {
+        std::size_t shader_switches = 0;
+        std::size_t texture_binds = 0;
+        std::size_t vertex_array_switches = 0;
+
+        Stats& operator+=(Stats const& rhs);
+    };
+
+    // depth is clamped to [0, 1], smaller depths sort first
+    static std::uint64_t make_key(Pass pass,
+                                  std::uint32_t shader,
+                                  std::uint32_t material,
+                                  std::uint32_t mesh,
+                                  float depth);
+
+    // Removes all items and keeps the memory
+    void clear();
+    void push(std::uint64_t key, std::uint32_t index);
+    // Sorts the items by key with a radix sort. Items with equal keys keep
+    // the order they were pushed in.
+    void sort();
+
+    std::size_t size() const { return queue.size(); }
+    bool empty() const { return queue.empty(); }
+    Item const& operator[](std::size_t i) const { return queue[i]; }
+
+private:
+    std::vector<Item> queue;
+    // Second buffer of the radix sort
+    std::vector<Item> scratch;
+};
+
+} // namespace Saturn
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef MVG_RENDER_THREAD_HPP_
+#define MVG_RENDER_THREAD_HPP_
+
+#include "RenderCommandList.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+struct GLFWwindow;
+
+namespace Saturn {
+
+// Draws frames on a thread of its own while the calling thread simulates the
+// next frame. The render thread owns the OpenGL context of the window for as
+// long as this object lives, so the calling thread must not make OpenGL calls
+// in the meantime. This is a dedicated thread rather than a job, because the
+// context can only be current on one thread.
+//
+// Frames are double buffered command lists. The calling thread records frame
+// N+1 into next_frame() while the render thread replays frame N, and submit()
+// hands it over once frame N is done.
+class RenderThread {
+public:
+    // Called on the render thread for every submitted frame. Replays the
+    // commands and presents the frame, for example by swapping the window's
+    // buffers.
+    using DrawFunction = std::function<void(RenderCommandList const&)>;
+
+    RenderThread(GLFWwindow* window, DrawFunction draw);
+
+    RenderThread(RenderThread const&) = delete;
+    RenderThread& operator=(RenderThread const&) = delete;
+
+    // Waits for the frame in flight and makes the context current on the
+    // calling thread again
+    ~RenderThread();
+
+    // Empty list to record the next frame into. The render thread never reads
+    // it before it is submitted.
+    RenderCommandList& next_frame();
+
+    // Waits until the render thread is done with the previous frame, then
+    // hands next_frame() over to it. Rethrows exceptions thrown while drawing
+    // the previous frame.
+    void submit();
+
+private:
+    void run();
+    // Blocks until no frame is in flight. Expects the lock to be held.
+    void wait_idle(std::unique_lock<std::mutex>& lock);
+
+    GLFWwindow* window;
+    DrawFunction draw;
+    std::array<RenderCommandList, 2> frames;
+    std::size_t write_index = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    // Frame handed over by submit and not drawn yet. Protected by mutex
+    RenderCommandList const* in_flight = nullptr;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    std::thread thread;
+};
+
+} // namespace Saturn
+
+#endif
@@ -4,9 +4,16 @@
 #include "Subsystems/AssetManager/AssetManager.hpp"
 #include "Subsystems/ECS/Components.hpp"
 #include "Subsystems/Scene/Scene.hpp"
+#include "Subsystems/Scene/SceneSnapshot.hpp"
 
 #include "DepthMap.hpp"
+#include "FrameContext.hpp"
 #include "Framebuffer.hpp"
+#include "GLRenderBackend.hpp"
+#include "LightsBlock.hpp"
+#include "RenderCommandList.hpp"
+#include "RenderFrame.hpp"
+#include "RenderQueue.hpp"
 #include "UniformBuffer.hpp"
 #include "Utility/Utility.hpp"
 #include "VertexArray.hpp"
@@ -14,6 +21,8 @@
 
 #include "glad/glad.h"
 
+#include <array>
+#include <cstdint>
 #include <functional>
 
 namespace Saturn {
@@ -27,6 +36,18 @@ public:
         Application& app;
     };
 
+    // Frustum culling results of the last recorded frame, summed over all
+    // views. Meshes without a material count in the camera pass too.
+    struct Stats {
+        std::size_t visible = 0;
+        std::size_t culled = 0;
+        // Meshes drawn to and skipped for the shadow map
+        std::size_t shadow_visible = 0;
+        std::size_t shadow_culled = 0;
+        // State changes recorded for the sorted draws of both passes
+        RenderQueue::Stats state_changes;
+    };
+
     Renderer(CreateInfo create_info);
 
     Renderer(Renderer const&) = delete;
@@ -36,35 +57,72 @@ public:
 
     ~Renderer();
 
+    // clear, render_scene, render_frame and update_screen record their
+    // commands and replay them right away on the calling thread
+
     void clear(Color clear_color,
                GLenum flags = GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
 
+    // Extracts the scene into a frame and renders it right away
     void render_scene(Scene& scene);
 
+    // Copies everything needed to draw the scene into out. Has to be called on
+    // the thread that updates the scene, after the update. Does not call any
+    // OpenGL functions.
+    void extract_frame(Scene& scene, RenderFrame& out);
+    // Same as above, but reads a snapshot instead of the scene, so it can run
+    // on any thread while the scene is updated. Does not touch the renderer,
+    // so the viewports are passed in, usually a copy of get_viewports() made
+    // on the thread that owns the renderer.
+    static void extract_frame(SceneSnapshot const& snapshot,
+                              std::vector<Viewport> const& viewports,
+                              RenderFrame& out);
+    // Draws an extracted frame. Only reads the frame, so the scene may be
+    // updated concurrently.
+    void render_frame(RenderFrame const& frame);
+
     void update_screen();
 
+    // Recording functions. These do not call any OpenGL functions, so they can
+    // run on another thread than the one that replays the list.
+    void record_clear(RenderCommandList& list,
+                      Color clear_color,
+                      GLenum flags = GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT);
+    void record_frame(RenderFrame const& frame, RenderCommandList& list);
+    // Copies the rendered frame to the screen
+    void record_screen_update(RenderCommandList& list);
+    // Extracts the scene and records everything needed to show it: clearing,
+    // drawing the frame and copying it to the screen
+    void record_scene(Scene& scene, RenderCommandList& list, Color clear_color);
+
+    // Backend that replays command lists as OpenGL calls. Has to be used on
+    // the thread the context is current on.
+    RenderBackend& backend();
+
+    // Only valid on the thread that records frames
+    Stats const& get_stats() const;
+
     // /brief Returns a reference to the viewport with specified index.
     // /param index: The index of the viewport to return. Viewport 0 is
     // initialized to be the full window
     Viewport& get_viewport(std::size_t index);
+    std::vector<Viewport> const& get_viewports() const;
 
     // /brief Adds a viewport to the renderer
     // /param vp: The viewport to add
     // /return The index of the newly added viewport
     std::size_t add_viewport(Viewport vp);
 
-    static constexpr std::size_t MaxLightsPerType = 15;
+    static constexpr std::size_t MaxLightsPerType =
+        LightsBlock::MaxLightsPerType;
 
 private:
-    struct LightSizesBytes {
-        static constexpr std::size_t PaddingAfterSizeVars = 4;
-        static constexpr std::size_t PointLightGLSL = 4 * sizeof(glm::vec4);
-        static constexpr std::size_t DirectionalLightGLSL =
-            4 * sizeof(glm::vec4);
-        static constexpr std::size_t SpotLightGLSL = 6 * sizeof(glm::vec4);
-    };
-
 	static constexpr std::size_t DepthMapPrecision = 1024;
+    // Meshes recorded by one job. Passes with fewer meshes are recorded on
+    // the calling thread.
+    static constexpr std::size_t MeshesPerRecordJob = 512;
+    static constexpr float NearPlane = 0.1f;
+    static constexpr float FarPlane = 100.0f;
 
     // Initialization
     void setup_framebuffer(CreateInfo const& create_info);
@@ -74,25 +132,73 @@ private:
     void load_default_shaders();
 	void create_depth_map();
 
-    // Rendering functions
-    void render_viewport(Scene& scene, Viewport& vp);
-	void render_to_depthmap(Scene& scene);
-    void render_particles(Scene& scene);
-	glm::mat4 get_lightspace_matrix(Scene& scene);
-    void send_camera_matrices(Scene& scene,
-                              Viewport& vp,
-                              Components::Camera& camera);
-    void send_lighting_data(Scene& scene);
+    // Extraction functions
+    // Whether light data changed since the previous extraction into frame
+    static bool lights_changed(Scene& scene, RenderFrame& frame);
+    static bool lights_changed(SceneSnapshot const& snapshot,
+                               RenderFrame& frame);
+    // Stores counts in frame, returns whether they differ
+    static bool light_counts_changed(std::array<std::size_t, 3> const& counts,
+                                     RenderFrame& frame);
+    void extract_lights(Scene& scene, RenderFrame& out);
+
+    // Computes the data of frame that the passes share
+    void build_context(RenderFrame const& frame, FrameContext& out);
+
+    // Rendering functions, recording into list
+    void render_viewport(RenderFrame const& frame,
+                         RenderFrame::View const& view,
+                         FrameContext::View const& matrices,
+                         RenderCommandList& list);
+    void render_to_depthmap(RenderFrame const& frame, RenderCommandList& list);
+    // Record the sorted draws [begin, end) of queue. Called from several
+    // jobs at once, so every range starts without any known state and leaves
+    // the textures unbound.
+    void record_shadow_draws(RenderFrame const& frame,
+                             std::size_t begin,
+                             std::size_t end,
+                             RenderCommandList& list,
+                             RenderQueue::Stats& changes);
+    void record_opaque_draws(RenderFrame const& frame,
+                             std::size_t begin,
+                             std::size_t end,
+                             glm::mat4 const& lightspace,
+                             RenderCommandList& list,
+                             RenderQueue::Stats& changes);
+    std::uint64_t sort_key(RenderQueue::Pass pass,
+                           RenderFrame::Mesh const& mesh,
+                           float depth);
+    // Records the instance data of all particle batches, once per frame
+    void upload_particles(RenderFrame const& frame, RenderCommandList& list);
+    // Only draws, the instance data is uploaded by upload_particles
+    void render_particles(RenderFrame const& frame, RenderCommandList& list);
+    glm::mat4 get_lightspace_matrix(RenderFrame const& frame);
+    glm::mat4 get_projection_matrix(RenderFrame::View const& view);
+    glm::mat4 get_view_matrix(RenderFrame::View const& view);
+    // Stores the indices of the meshes of the frame that intersect the view
+    // volume in visible
+    void cull_meshes(RenderFrame const& frame,
+                     glm::mat4 const& view_projection,
+                     std::vector<std::uint32_t>& visible);
+    void send_camera_matrices(RenderFrame::View const& view,
+                              FrameContext::View const& matrices,
+                              RenderCommandList& list);
+    void send_lighting_data(RenderFrame const& frame, RenderCommandList& list);
     void send_model_matrix(Shader& shader,
-                           Components::Transform const& relative_transform);
-    void send_material_data(Shader& shader, Components::Material& material);
-    void unbind_textures(Components::Material& material);
-
-    // Utility functions
-    std::vector<Components::PointLight*> collect_point_lights(Scene& scene);
-    std::vector<Components::DirectionalLight*>
-    collect_directional_lights(Scene& scene);
-    std::vector<Components::SpotLight*> collect_spot_lights(Scene& scene);
+                           glm::mat4 const& model,
+                           RenderCommandList& list);
+    // Sets the material uniforms. The textures are bound by the caller.
+    void send_material_data(Shader& shader,
+                            RenderFrame::Mesh const& mesh,
+                            RenderCommandList& list);
+    // Calls record_range(begin, end, list, changes) for the items of queue,
+    // split across the job system. Each job records into a list of its own,
+    // and the lists are appended to list in queue order. record_range runs
+    // concurrently, so it may only record.
+    template<typename F>
+    void record_queue(RenderCommandList& list, F&& record_range);
+    // Replays commands into gl_backend and empties it
+    void replay_commands();
 
     // Member variables
     std::reference_wrapper<Application> app;
@@ -103,13 +209,34 @@ private:
     VertexArray screen;
     UniformBuffer matrix_buffer;
     UniformBuffer lights_buffer;
+    // Contents of lights_buffer
+    LightsBlock lights_block;
     UniformBuffer camera_buffer;
 	DepthMap shadow_depth_map;
     Resource<Shader> no_shader_error;
     // #MaybeTODO: Move this to ParticleEmitter?
     Resource<Shader> particle_shader;
 	Resource<Shader> depth_shader;
+    Resource<Texture> default_particle_texture;
     std::vector<Viewport> viewports;
+    // Frame used by render_scene and record_scene
+    RenderFrame frame;
+    // Commands recorded by the immediate functions
+    RenderCommandList commands;
+    GLRenderBackend gl_backend;
+    // One list and its state changes per job of record_queue, reused across
+    // passes
+    std::vector<RenderCommandList> mesh_lists;
+    std::vector<RenderQueue::Stats> mesh_list_stats;
+    // Sorted draws of the pass being recorded
+    RenderQueue queue;
+    // Shared data of the frame being recorded
+    FrameContext context;
+    // Meshes visible in the view being recorded
+    std::vector<std::uint32_t> visible_meshes;
+    Stats stats;
+    // Screen viewport of the last rendered frame, used by update_screen
+    Viewport screen_viewport;
 };
 
 } // namespace Saturn
@@ -0,0 +1,64 @@
+#ifndef MVG_STD140_HPP_
+#define MVG_STD140_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+// Offsets of uniform block members laid out with the std140 rules of the
+// OpenGL specification (section 7.6.2.2), computed at compile time
+namespace Saturn::std140 {
+
+// Base alignment and size in bytes
+struct Type {
+    std::size_t alignment;
+    std::size_t size;
+};
+
+inline constexpr Type Int{4, 4};
+inline constexpr Type Float{4, 4};
+inline constexpr Type Vec2{8, 8};
+inline constexpr Type Vec3{16, 12};
+inline constexpr Type Vec4{16, 16};
+inline constexpr Type Mat4{16, 64};
+
+constexpr std::size_t align_up(std::size_t offset, std::size_t alignment) {
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+// Distance between the elements of an array. Elements are aligned like a
+// vec4, so the stride of small types is rounded up to 16 bytes.
+constexpr std::size_t array_stride(Type element) {
+    return align_up(std::max(element.size, element.alignment), 16);
+}
+
+constexpr Type array(Type element, std::size_t count) {
+    return {align_up(element.alignment, 16), array_stride(element) * count};
+}
+
+// Offsets of the members of a struct or block in declaration order. The
+// struct is aligned like a vec4 and its size is padded to its alignment.
+template<std::size_t N>
+struct Struct {
+    constexpr explicit Struct(std::array<Type, N> const& members) {
+        std::size_t offset = 0;
+        alignment = 16;
+        for (std::size_t i = 0; i < N; ++i) {
+            offset = align_up(offset, members[i].alignment);
+            offsets[i] = offset;
+            offset += members[i].size;
+            alignment = std::max(alignment, members[i].alignment);
+        }
+        size = align_up(offset, alignment);
+    }
+
+    constexpr Type type() const { return {alignment, size}; }
+
+    std::array<std::size_t, N> offsets{};
+    std::size_t alignment = 0;
+    std::size_t size = 0;
+};
+
+} // namespace Saturn::std140
+
+#endif
@@ -38,6 +38,7 @@ public:
     void set_float(float value, std::size_t byte_offset);
     void set_vec3(glm::vec3 const& value, std::size_t byte_offset);
     void set_mat4(glm::mat4 const& value, std::size_t byte_offset);
+    void set_data(void const* data, std::size_t size, std::size_t byte_offset);
 
 private:
     unsigned int ubo;
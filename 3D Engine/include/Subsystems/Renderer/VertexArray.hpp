@@ -39,6 +39,9 @@ public:
 
     VertexArray() = default;
     VertexArray(CreateInfo const& create_info);
+    // Makes no OpenGL calls. The result can be recorded into render command
+    // lists, but not drawn or assigned.
+    explicit VertexArray(Headless);
 
     VertexArray(VertexArray const&) = delete;
     VertexArray(VertexArray&& rhs) = delete;
@@ -62,7 +65,7 @@ public:
 	// Returns the index of the added buffer
 	std::size_t add_buffer(BufferInfo const& info);
 
-	void update_buffer_data(std::size_t buffer_index, float* data, std::size_t count);
+	void update_buffer_data(std::size_t buffer_index, float const* data, std::size_t count);
 
 private:
 	friend class Renderer;
@@ -73,8 +76,8 @@ private:
     std::vector<std::unique_ptr<Vbo<BufferTarget::ArrayBuffer>>> buffers;
     Vbo<BufferTarget::ElementArrayBuffer> ebo;
 
-	std::size_t vertex_count;
-	std::size_t indices_size;
+	std::size_t vertex_count = 0;
+	std::size_t indices_size = 0;
 
 	std::vector<GLuint> indices;
 };
@@ -1,6 +1,7 @@
 #ifndef MVG_VIEWPORT_HPP_
 #define MVG_VIEWPORT_HPP_
 
+#include "Subsystems/ECS/Entity.hpp"
 #include "Utility/Utility.hpp"
 
 namespace Saturn {
@@ -9,7 +10,7 @@ class Viewport {
 public:
     Viewport() = default;
     Viewport(unsigned int x, unsigned int y, unsigned int w, unsigned int h);
-    Viewport(std::size_t cam, unsigned int x, unsigned int y, unsigned int w, unsigned int h);
+    Viewport(Entity cam, unsigned int x, unsigned int y, unsigned int w, unsigned int h);
 
     WindowDim dimensions() const;
     WindowDim position() const;
@@ -19,15 +20,15 @@ public:
 
     static void set_active(Viewport const& viewport);
    
-	std::size_t get_camera() const;
-	void set_camera(std::size_t cam_id);
+	Entity get_camera() const;
+	void set_camera(Entity cam);
 
 	bool has_camera() const;
 
 private:
     unsigned int x, y;
     unsigned int w, h;
-    std::size_t camera = static_cast<std::size_t>(-1);
+    Entity camera;
 };
 
 } // namespace Saturn
@@ -0,0 +1,93 @@
+#ifndef MVG_COMMAND_BUFFER_HPP_
+#define MVG_COMMAND_BUFFER_HPP_
+
+#include "Subsystems/Scene/SceneObject.hpp"
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace Saturn {
+
+class Scene;
+
+// Records structural changes to a scene (creating and destroying objects,
+// adding and removing components) so that they can be made while systems are
+// iterating over components. The recorded commands are applied in one batch,
+// in recording order, after all systems have run for the frame. Commands may
+// be recorded from multiple threads at once. Objects are referred to by
+// entity handle, and commands on objects that no longer exist when the buffer
+// is applied are skipped.
+class CommandBuffer {
+public:
+    using ObjectCallback = std::function<void(SceneObject&)>;
+
+    CommandBuffer() = default;
+    CommandBuffer(CommandBuffer const&) = delete;
+    CommandBuffer& operator=(CommandBuffer const&) = delete;
+
+    // Creates an object once the buffer is applied. init is called with the
+    // new object right after it was created.
+    void create_object(Entity parent = Entity{}, ObjectCallback init = nullptr);
+
+    // Destroys the object and its children once the buffer is applied, see
+    // Scene::destroy_object
+    void destroy_object(Entity entity);
+
+    template<typename C>
+    void add_component(Entity entity, C component = C{}) {
+        record(index_of<C>(),
+               [entity, c = std::move(component)](Scene& scene) mutable {
+                   if (auto* obj = object(scene, entity)) {
+                       obj->add_component<C>(std::move(c));
+                   }
+               });
+    }
+
+    template<typename C>
+    void remove_component(Entity entity) {
+        record(SceneObject::component_count, [entity](Scene& scene) {
+            if (auto* obj = object(scene, entity)) {
+                obj->remove_component<C>();
+            }
+        });
+    }
+
+    // Applies all recorded commands. Commands recorded while applying (for
+    // example from a create_object callback) are kept for the next call.
+    void apply(Scene& scene);
+
+    bool empty() const;
+
+private:
+    using Command = std::function<void(Scene&)>;
+
+    template<typename C>
+    static constexpr std::size_t index_of() {
+        constexpr auto idx = SceneObject::component_table::get<C>();
+        static_assert(idx != SceneObject::component_table::not_found,
+                      "Component type is not in COMPONENT_LIST");
+        return idx;
+    }
+
+    // Returns nullptr if the object is no longer alive
+    static SceneObject* object(Scene& scene, Entity entity);
+
+    // component is the index of the component type the command adds, or
+    // component_count if it does not add a component
+    void record(std::size_t component, Command command);
+
+    mutable std::mutex mutex;
+    std::vector<Command> commands;
+    // Commands being applied. Swapped with commands, so that both keep
+    // their memory between frames. Only used by apply.
+    std::vector<Command> batch;
+    // Amount of recorded component additions per component type, used to
+    // reserve storage before applying
+    std::array<std::size_t, SceneObject::component_count> pending_adds{};
+};
+
+} // namespace Saturn
+
+#endif
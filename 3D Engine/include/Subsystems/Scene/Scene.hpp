@@ -1,20 +1,25 @@
 #ifndef MVG_SCENE_HPP_
 #define MVG_SCENE_HPP_
 
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string_view>
 
 #include "Subsystems/ECS/Components.hpp"
+#include "Subsystems/ECS/Entity.hpp"
 
 #include "Subsystems/ECS/ECS.hpp"
 #include "Subsystems/ECS/ComponentList.hpp"
+#include "Subsystems/ECS/snapshot_buffer.hpp"
+#include "Subsystems/Scene/SceneSnapshot.hpp"
+#include "Subsystems/Scene/TransformHierarchy.hpp"
 
 
 namespace Saturn {
 
 class Application;
-
+class CommandBuffer;
 class SceneObject;
 
 class Scene {
@@ -29,24 +34,87 @@ public:
     ~Scene();
 
 	void on_start();
+    // Runs the fixed update systems once for every Time::fixedDeltaTime that
+    // passed (at most Time::maxFixedSteps times), then the variable update
+    // systems once
 	void update_systems();
 
     SceneObject& create_object(SceneObject* parent = nullptr);
     SceneObject& create_object_from_file(std::string_view file_path, SceneObject* parent = nullptr);
 
+    // Destroys an object and all of its children. The object stays alive
+    // until the end of the current update_systems call (or the next one, if
+    // called outside of it), where all pending destructions are processed in
+    // one batch. Destroying an object that is already dead or pending does
+    // nothing. Must be called from the main thread, systems should use
+    // CommandBuffer::destroy_object instead.
+    void destroy_object(Entity entity);
+    void destroy_objects(std::vector<Entity> const& entities);
+
+    // Returns the object an entity handle refers to, or nullptr if the handle
+    // does not refer to a live object
+    SceneObject* get_object(Entity entity);
+    SceneObject const* get_object(Entity entity) const;
+    bool is_alive(Entity entity) const;
+
 	ECS<COMPONENT_LIST>& get_ecs();
 
+    // Structural changes recorded here are applied after all systems have
+    // been updated
+    CommandBuffer& get_commands();
+
 	void serialize_to_file(std::string_view folder);
 	void deserialize_from_file(std::string_view path);
 
+    // Copies every live object and its components into out, reusing its
+    // memory. Must be called from the main thread outside of update_systems.
+    void capture_snapshot(SceneSnapshot& out);
+    // Captures into the back buffer of the scene's snapshots and publishes
+    // it. Same threading rules as capture_snapshot.
+    void publish_snapshot();
+    // Latest published snapshot. Safe to call from any thread, and does not
+    // block.
+    snapshot_buffer<SceneSnapshot>::read_handle latest_snapshot();
+
+    // Writes the files serialize_to_file writes, from a snapshot. Only reads
+    // the snapshot, so it may run on any thread.
+    static void serialize_snapshot(SceneSnapshot const& snapshot,
+                                   std::string_view folder);
+
 	Application* get_app();
 
 private:
-    std::vector<std::unique_ptr<SceneObject>> objects;
+    struct EntitySlot {
+        std::unique_ptr<SceneObject> object;
+        // Bumped every time the slot is reused for a new object
+        std::uint32_t generation = 0;
+        bool destroy_pending = false;
+    };
+
+    // Removes the components of every object pending destruction and frees
+    // their slots
+    void destroy_pending_objects();
+    bool has_pending_ancestor(SceneObject const& object) const;
+    void run_fixed_steps();
+
+    // Entity table. The index of an entity is the index of its slot
+    std::vector<EntitySlot> entities;
+    // Indices of free slots, reused before the table grows
+    std::vector<std::uint32_t> free_slots;
+    std::vector<Entity> pending_destroy;
     ECS<COMPONENT_LIST> ecs;
+    std::unique_ptr<CommandBuffer> commands;
+    TransformHierarchy transforms;
+    snapshot_buffer<SceneSnapshot> snapshots;
+    // Time that passed but was not simulated by a fixed step yet
+    float fixed_time_accumulator = 0.0f;
 	Application* app;
 };
 
 } // namespace Saturn
 
+// SceneObject needs the complete Scene type, so it is included after the Scene
+// definition.
+#include "Subsystems/Scene/SceneObject.hpp"
+
 #endif
@@ -1,15 +1,17 @@
 #ifndef MVG_SCENE_OBJECT_HPP_
 #define MVG_SCENE_OBJECT_HPP_
 
+#include "Subsystems/ECS/ComponentList.hpp"
 #include "Subsystems/ECS/Components.hpp"
+#include "Subsystems/ECS/Entity.hpp"
+#include "Subsystems/ECS/component_index.hpp"
 #include "Subsystems/Scene/Scene.hpp"
 #include "Subsystems/Serialization/ComponentSerializers.hpp"
-#include "Utility/IDGenerator.hpp"
 
 #include <nlohmann/json.hpp>
 
-#include <typeindex>
-#include <typeinfo>
+#include <bitset>
+#include <type_traits>
 
 namespace Saturn {
 
@@ -19,56 +21,84 @@ class SceneObject {
 public:
     friend class Scene;
 
+    using component_table = component_index_table<COMPONENT_LIST>;
+    static constexpr std::size_t component_count = component_table::size;
+    // Bit i is set if the object has the component at index i in
+    // COMPONENT_LIST
+    using signature_type = std::bitset<component_count>;
+
+    static_assert(component_count <= 64,
+                  "Component masks are built from a 64-bit integer");
+
     SceneObject() = default;
-    SceneObject(Scene* s, SceneObject* parent = nullptr);
+    SceneObject(Scene* s, Entity handle, Entity parent = Entity{});
+
+    // Returns the signature mask with the bits for all of Cs set
+    template<typename... Cs>
+    static signature_type signature_of() {
+        return signature_type(mask_of<Cs...>());
+    }
 
+    // Adds a component and returns its id. Components are identified by the
+    // index of their entity, so this is the same for every component of this
+    // object.
     template<typename C, typename... Args>
     std::size_t add_component(Args&&... args) {
         auto& ecs = scene->ecs;
-        auto& container = ecs.get_components<C>();
-
-        // Grab a new id for this component
-
-        auto it = container.push_back(C{std::forward<Args>(args)...});
-        it->entity = this;
-        component_ids[typeid(C)] = it->id;
+        ecs.add_component<C>(entity, C{std::forward<Args>(args)...});
+        signature.set(index_of<C>());
+        if constexpr (std::is_same_v<C, Components::Transform>) {
+            scene->transforms.invalidate();
+        }
 
-        return it->id;
+        return entity.index;
     }
 
     template<typename C>
     bool has_component() const {
-        return component_ids.find(typeid(C)) != component_ids.end();
+        return signature[index_of<C>()];
     }
 
+    template<typename... Cs>
+    bool has_components() const {
+        auto const mask = signature_of<Cs...>();
+        return (signature & mask) == mask;
+    }
+
+    signature_type const& get_signature() const { return signature; }
+
     template<typename C>
     C& get_component() {
-        auto& ecs = scene->ecs;
-        auto& container = ecs.get_components<C>();
-
-        return container.get_with_id(component_ids[typeid(C)]);
+        return scene->ecs.get_component<C>(entity);
     }
 
     template<typename C>
     C const& get_component() const {
-        auto& ecs = scene->ecs;
-        auto& container = ecs.get_components<C>();
-
-        return container.get_with_id(component_ids.at(typeid(C)));
+        return scene->ecs.get_component<C const>(entity);
     }
 
     template<typename C>
     void remove_component() {
-        auto& ecs = scene->ecs;
-        auto& container = ecs.get_components<C>();
-        std::type_index ti = typeid(C);
-        container.erase_component(component_ids.at(ti));
-        component_ids.erase(ti);
+        scene->ecs.remove_component<C>(entity);
+        signature.reset(index_of<C>());
+        if constexpr (std::is_same_v<C, Components::Transform>) {
+            scene->transforms.invalidate();
+        }
+    }
+
+    // Removes every component this object has
+    void remove_all_components() {
+        remove_components_if_present<COMPONENT_LIST>();
     }
 
+    Entity get_entity() const { return entity; }
+
     bool has_parent() const;
+    // Returns the parent object, or nullptr if there is none or it was
+    // destroyed
     SceneObject* parent();
     SceneObject const* parent() const;
+    Entity get_parent_entity() const { return parent_entity; }
 
     inline Scene* get_scene() { return scene; }
 
@@ -90,11 +120,29 @@ public:
     friend void from_json(nlohmann::json const& j, SceneObject& obj);
 
 private:
+    template<typename C>
+    static constexpr std::size_t index_of() {
+        constexpr auto idx = component_table::get<C>();
+        static_assert(idx != component_table::not_found,
+                      "Component type is not in COMPONENT_LIST");
+        return idx;
+    }
+
+    template<typename... Cs>
+    void remove_components_if_present() {
+        ((has_component<Cs>() ? remove_component<Cs>() : void()), ...);
+    }
+
+    template<typename... Cs>
+    static constexpr unsigned long long mask_of() {
+        return ((1ull << index_of<Cs>()) | ... | 0ull);
+    }
+
     Scene* scene;
-    SceneObject* parent_obj;
-    // Maps a component type to a component id. The id will be translated in an
-    // index in the ECS class
-    std::unordered_map<std::type_index, std::size_t> component_ids;
+    Entity entity;
+    Entity parent_entity;
+    // Which components this object has, indexed like COMPONENT_LIST
+    signature_type signature;
 };
 
 void to_json(nlohmann::json& j, SceneObject const& obj);
@@ -0,0 +1,23 @@
+#ifndef MVG_SCENE_SNAPSHOT_HPP_
+#define MVG_SCENE_SNAPSHOT_HPP_
+
+#include "Subsystems/ECS/ComponentList.hpp"
+#include "Subsystems/ECS/Entity.hpp"
+#include "Subsystems/ECS/ecs_snapshot.hpp"
+
+#include <vector>
+
+namespace Saturn {
+
+// Frozen state of a Scene, filled by Scene::capture_snapshot. Tools that run
+// next to the simulation, like serializers, profilers or the renderer, read
+// this instead of the live scene.
+struct SceneSnapshot {
+    ecs_snapshot<COMPONENT_LIST> ecs;
+    // Live objects, in the order of the scene's entity table
+    std::vector<Entity> entities;
+};
+
+} // namespace Saturn
+
+#endif
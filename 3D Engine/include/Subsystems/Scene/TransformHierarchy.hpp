@@ -0,0 +1,95 @@
+#ifndef MVG_TRANSFORM_HIERARCHY_HPP_
+#define MVG_TRANSFORM_HIERARCHY_HPP_
+
+#include "Subsystems/ECS/Entity.hpp"
+#include "Subsystems/Math/Transform.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace Saturn {
+
+class Scene;
+
+namespace Components {
+struct Transform;
+}
+
+// Keeps Transform::world_matrix up to date for every object in a scene. All
+// objects with a Transform are stored in a flat array sorted by depth, so
+// parents always come before their children. An update is a single linear
+// pass over that array: a transform is recomputed only if it changed since
+// the previous update or if its parent was recomputed. Clean nodes only cost
+// a change tick comparison.
+//
+// Positions of parents are added, rotations multiplied as quaternions and
+// scales multiplied. The world matrices of all recomputed nodes are then
+// built in one batch by Math::compose_model_matrices.
+//
+// When fixed update systems move objects, the world matrices are
+// interpolated between the transforms before and after the last fixed step,
+// so motion stays smooth when frames and steps do not line up.
+class TransformHierarchy {
+public:
+    // fixed_step is true when called right after the fixed update systems
+    void update(Scene& scene, bool fixed_step = false);
+
+    // Called before every fixed step
+    void begin_fixed_step();
+    // Overwrites the world matrices of the nodes moved by the last fixed
+    // step with their transform at alpha between the two steps. Called
+    // after the update that ends a frame.
+    void interpolate(Scene& scene, float alpha);
+
+    // Has to be called when objects with a Transform are created or
+    // destroyed, or Transform components are added or removed. The flat
+    // array is rebuilt on the next update.
+    void invalidate();
+
+private:
+    static constexpr std::uint32_t no_parent = static_cast<std::uint32_t>(-1);
+
+    struct Node {
+        Entity entity;
+        // Position of the closest ancestor with a Transform in nodes
+        std::uint32_t parent;
+    };
+
+    // State of a node with regard to interpolation. Moving nodes moved in
+    // the last fixed step. Settling nodes moved in the step before, and are
+    // written once more at their current transform.
+    enum class Motion : std::uint8_t { none, moving, settling };
+
+    void rebuild(Scene& scene);
+    // Builds the matrices of batch and writes them to targets
+    void write_batch();
+
+    std::vector<Node> nodes;
+    // Absolute transform of every node, used by its children. Same order as
+    // nodes.
+    Math::TransformLanes absolute;
+    // Absolute transform of every node before the last fixed step that
+    // moved it. Only meaningful for nodes that are interpolated.
+    Math::TransformLanes previous;
+    std::vector<Motion> motion;
+    // Positions of all nodes with a motion other than none
+    std::vector<std::uint32_t> interpolated;
+    // Whether a node was recomputed during the current update. Outside of
+    // update, marks nodes that rebuild wants recomputed regardless of ticks.
+    std::vector<bool> dirty;
+    // Absolute transforms of the nodes recomputed during an update, the
+    // components their matrices go to and the matrices themselves. Kept
+    // around to reuse their memory.
+    Math::TransformLanes batch;
+    std::vector<Components::Transform*> targets;
+    std::vector<glm::mat4> matrices;
+    std::vector<glm::mat3> rotations;
+    bool needs_rebuild = true;
+    std::uint32_t last_update_tick = 0;
+};
+
+} // namespace Saturn
+
+#endif
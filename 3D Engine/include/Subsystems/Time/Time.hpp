@@ -7,6 +7,16 @@ class Time {
 public:
     static inline float deltaTime;
 
+    // Length of a fixed update step in seconds
+    static inline float fixedDeltaTime = 1.0f / 60.0f;
+    // Most fixed steps run in one frame. Time beyond that is dropped, so a
+    // slow frame slows the simulation down instead of making it fall further
+    // behind.
+    static inline int maxFixedSteps = 5;
+    // How far the current frame is between the last two fixed steps, from 0
+    // to 1
+    static inline float fixedAlpha = 0.0f;
+
     static float now();
     static void update();
    
@@ -7,6 +7,8 @@
 
 namespace Saturn {
 
+class Scene;
+
 #define log_function_info(sev)                                                 \
     ::Saturn::LogSystem::write(sev, __PRETTY_FUNCTION__);
 
@@ -44,8 +46,6 @@ public:
     NonCopyable& operator=(NonCopyable const&) = delete;
 };
 
-Components::Transform make_absolute_transform(Components::Transform const& old_transform);
-
 std::vector<float> make_float_vec(std::vector<glm::vec4> const& v);
 std::vector<float> make_float_vec(std::vector<glm::vec3> const& v);
 
@@ -5,6 +5,7 @@
 #include "Subsystems/Input/Input.hpp"
 #include "Subsystems/Logging/LogSystem.hpp"
 #include "Subsystems/Math/Math.hpp"
+#include "Subsystems/Renderer/RenderThread.hpp"
 #include "Subsystems/Renderer/Viewport.hpp"
 #include "Subsystems/Scene/Scene.hpp"
 #include "Subsystems/Scene/SceneObject.hpp"
@@ -17,7 +18,8 @@
 namespace Saturn {
 
 Application::Application(CreateInfo create_info) :
-    window_handle(nullptr), window_dimensions(create_info.window_size) {
+    window_handle(nullptr), window_dimensions(create_info.window_size),
+    pipelined_rendering(create_info.pipelined_rendering) {
 
     // If fullscreen is true, set this to glfwGetPrimaryMonitor() to enable
     // fullscreen. If it's nullptr, fullscreen will be disabled
@@ -43,7 +45,8 @@ Application::Application(CreateInfo create_info) :
 Application::Application(Application&& other) :
     window_handle(other.window_handle),
     window_dimensions(other.window_dimensions),
-    window_is_open(other.window_is_open) {
+    window_is_open(other.window_is_open),
+    pipelined_rendering(other.pipelined_rendering) {
 
     other.window_handle = nullptr;
     other.window_is_open = false;
@@ -53,6 +56,7 @@ Application& Application::operator=(Application&& other) {
     window_dimensions = other.window_dimensions;
     window_handle = other.window_handle;
     window_is_open = other.window_is_open;
+    pipelined_rendering = other.pipelined_rendering;
 
     other.window_is_open = false;
     other.window_handle = nullptr;
@@ -155,7 +159,7 @@ void Application::run() {
          freelook.mouse_sensitivity = 0.08f;
          zoom.zoom_speed = 100.0f;
 
-         renderer->get_viewport(0).set_camera(camera.id);
+         renderer->get_viewport(0).set_camera(main_cam.get_entity());
      }*/
 
     scene.deserialize_from_file("resources/scene0/scene.dat");
@@ -167,6 +171,10 @@ void Application::run() {
     });
 
     scene.on_start();
+    if (pipelined_rendering) {
+        run_pipelined(scene);
+        return;
+    }
     while (!glfwWindowShouldClose(window_handle)) {
         Time::update();
         Input::update();
@@ -186,6 +194,34 @@ void Application::run() {
     }
 }
 
+void Application::run_pipelined(Scene& scene) {
+    render_thread_active = true;
+    {
+        RenderThread render_thread(
+            window_handle, [this](RenderCommandList const& commands) {
+                commands.replay(renderer->backend());
+                glfwSwapBuffers(window_handle);
+            });
+
+        // Each iteration updates the scene while the render thread draws the
+        // previous frame, so a frame takes as long as the slower of the two
+        while (!glfwWindowShouldClose(window_handle)) {
+            Time::update();
+            Input::update();
+
+            scene.update_systems();
+            renderer->record_scene(scene, render_thread.next_frame(),
+                                   Color{0.003f, 0.003f, 0.003f, 1.0f});
+            render_thread.submit();
+
+            Input::tick_end();
+
+            glfwPollEvents();
+        }
+    }
+    render_thread_active = false;
+}
+
 void Application::quit() {
     if (window_handle != nullptr) {
         glfwSetWindowShouldClose(window_handle, true);
@@ -196,6 +232,9 @@ void Application::quit() {
 void Application::resize_callback([[maybe_unused]] GLFWwindow* window,
                                   int w,
                                   int h) {
+    // The renderer sets the viewport every frame anyway. Without the context
+    // this thread must not call OpenGL.
+    if (render_thread_active) { return; }
     // Set the viewport correctly
     Viewport::set_active(Viewport(0u, 0u, static_cast<unsigned int>(w),
                                   static_cast<unsigned int>(h)));
@@ -1,6 +1,6 @@
 #include "Core/Engine.hpp"
 
-#include <thread>
+#include "Subsystems/Renderer/GLStateCache.hpp"
 
 namespace Saturn {
 
@@ -21,6 +21,9 @@ Application* framebuffer_resize_callback::app = nullptr;
 Application Engine::initialize(CreateInfo create_info) {
     // Initialize logging system
     LogSystem::initialize(create_info.log_target);
+    // Start the worker threads. Everything else that runs concurrently is
+    // scheduled on them.
+    JobSystem::initialize();
     // Initialize GLFW
     if (!glfwInit()) {
         LogSystem::write(LogSystem::Severity::FatalError,
@@ -74,10 +77,11 @@ Application Engine::initialize(CreateInfo create_info) {
                                    framebuffer_resize_callback::callback);
 
     // Enable some OpenGL functionality we're going to need
-    glEnable(GL_CULL_FACE);
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    auto& gl_state = GLStateCache::get();
+    gl_state.enable(GL_CULL_FACE);
+    gl_state.enable(GL_DEPTH_TEST);
+    gl_state.enable(GL_BLEND);
+    gl_state.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     // Enable debug output if specified
     if (create_info.enable_debug_output) {
@@ -95,15 +99,16 @@ Application Engine::initialize(CreateInfo create_info) {
         }
     }
 
-    // Initialize subsystems. This process is multithreaded for all subsystems.
-    std::thread input_init([&app]() {
+    // Initialize subsystems. Subsystems that do not need the OpenGL context
+    // are initialized as jobs.
+    auto input_init = JobSystem::schedule([&app]() {
         Input::initialize(app);
         // Bind the escape key to quit. This may change in the future or be
         // configurable somewhere
         Input::bind(GLFW_KEY_ESCAPE, [&app]() { app.quit(); });
     });
 
-    std::thread random_init(Math::RandomEngine::initialize);
+    auto random_init = JobSystem::schedule(Math::RandomEngine::initialize);
 
     // Single threaded Renderer initialization, because calling OpenGL functions
     // from a different thread isn't a good idea
@@ -113,9 +118,8 @@ Application Engine::initialize(CreateInfo create_info) {
 
     app.initialize_keybinds();
 
-    // Join all subsystem threads
-    input_init.join();
-    random_init.join();
+    // Wait for all subsystem jobs
+    JobSystem::wait({input_init, random_init});
 
     return app;
 }
@@ -9,10 +9,17 @@
 
 namespace Saturn::Systems {
 
+void CameraZoomControllerSystem::on_start(Scene& scene) {
+    scene.get_ecs()
+        .register_query<Components::Camera,
+                        Components::CameraZoomController const>();
+}
+
 void CameraZoomControllerSystem::on_update(Scene& scene) {
     for (auto [cam, zoom_controller] :
          scene.get_ecs()
-             .select<Components::Camera, Components::CameraZoomController>()) {
+             .query<Components::Camera,
+                    Components::CameraZoomController const>()) {
 
         auto mouse = Input::mouse();
 
@@ -14,16 +14,19 @@ namespace Saturn {
 
 namespace Systems {
 
-void FPSCameraControllerSystem::on_start(Scene&) {
+void FPSCameraControllerSystem::on_start(Scene& scene) {
     Input::enable_mouse_capture();
+    scene.get_ecs()
+        .register_query<Components::Transform, Components::Camera const,
+                        Components::FPSCameraController const>();
 }
 
 void FPSCameraControllerSystem::on_update(Scene& scene) {
     auto& ecs = scene.get_ecs();
 
     for (auto [trans, cam, controller] :
-         ecs.select<Components::Transform, Components::Camera,
-                    Components::FPSCameraController>()) {
+         ecs.query<Components::Transform, Components::Camera const,
+                   Components::FPSCameraController const>()) {
 
 
         float speed = controller.speed * Time::deltaTime;
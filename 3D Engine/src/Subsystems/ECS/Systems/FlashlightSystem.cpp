@@ -6,10 +6,15 @@
 
 namespace Saturn::Systems {
 
+void FlashlightSystem::on_start(Scene& scene) {
+    using namespace Components;
+    scene.get_ecs().register_query<Camera const, SpotLight>();
+}
+
 void FlashlightSystem::on_update(Scene& scene) {
     using namespace Components;
 
-    for (auto [cam, light] : scene.get_ecs().select<Camera, SpotLight>()) {
+    for (auto [cam, light] : scene.get_ecs().query<Camera const, SpotLight>()) {
         light.direction = cam.front;
     }
 }
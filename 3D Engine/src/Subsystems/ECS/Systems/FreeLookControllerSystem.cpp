@@ -14,13 +14,26 @@
 
 namespace Saturn::Systems {
 
+void FreeLookControllerSystem::on_start(Scene& scene) {
+    using namespace Components;
+    auto& ecs = scene.get_ecs();
+    ecs.register_query<Transform, Camera, FreeLookController>();
+
+    for (auto [transform, cam, controller] :
+         ecs.query<Transform, Camera, FreeLookController>()) {
+        auto const euler = Math::quat_to_euler(transform.rotation);
+        controller.pitch = euler.x;
+        controller.yaw = euler.y;
+    }
+}
+
 void FreeLookControllerSystem::on_update(Scene& scene) {
     using namespace Components;
 
     auto& ecs = scene.get_ecs();
 
     for (auto [transform, cam, controller] :
-         ecs.select<Transform, Camera, FreeLookController>()) {
+         ecs.query<Transform, Camera, FreeLookController>()) {
 
         auto mouse = Input::mouse();
         auto prev_mouse = Input::previous_mouse();
@@ -39,19 +52,22 @@ void FreeLookControllerSystem::on_update(Scene& scene) {
         // x and y flipped. This is not a bug, since rotation around y means
         // looking around left/right, which is controlled by moving the mouse
         // left and right
-        transform.rotation.x += yoffset;
-        transform.rotation.y += xoffset;
+        controller.pitch += yoffset;
+        controller.yaw += xoffset;
 
         static float max_pitch = 89.0f;
         static float min_pitch = -89.0f;
-        if (transform.rotation.x > max_pitch) transform.rotation.x = max_pitch;
-        if (transform.rotation.x < min_pitch) transform.rotation.x = min_pitch;
+        if (controller.pitch > max_pitch) controller.pitch = max_pitch;
+        if (controller.pitch < min_pitch) controller.pitch = min_pitch;
+
+        transform.rotation =
+            Math::euler_to_quat({controller.pitch, controller.yaw, 0.0f});
 
         // Rotation
-        auto cos_pitch = std::cos(glm::radians(transform.rotation.x));
-        auto cos_yaw = std::cos(glm::radians(transform.rotation.y));
-        auto sin_pitch = std::sin(glm::radians(transform.rotation.x));
-        auto sin_yaw = std::sin(glm::radians(transform.rotation.y));
+        auto cos_pitch = std::cos(glm::radians(controller.pitch));
+        auto cos_yaw = std::cos(glm::radians(controller.yaw));
+        auto sin_pitch = std::sin(glm::radians(controller.pitch));
+        auto sin_yaw = std::sin(glm::radians(controller.yaw));
         cam.front.x = cos_pitch * cos_yaw;
         cam.front.y = sin_pitch;
         cam.front.z = cos_pitch * sin_yaw;
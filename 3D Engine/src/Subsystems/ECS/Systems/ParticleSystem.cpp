@@ -6,10 +6,7 @@
 #include "Subsystems/Scene/Scene.hpp"
 #include "Subsystems/Time/Time.hpp"
 
-#include "Utility/Utility.hpp"
-
 #include <algorithm>
-#include <glm/gtc/type_ptr.hpp>
 
 namespace Saturn::Systems {
 
@@ -30,67 +27,57 @@ std::size_t ParticleSystem::particles_to_spawn(
 void ParticleSystem::on_update(Scene& scene) {
     using namespace Components;
 
-    for (auto [emitter] : scene.get_ecs().select<ParticleEmitter>()) {
+    auto emitters = scene.get_ecs().select<ParticleEmitter>();
 
-        // Check if we need to continue spawning particles
+    // Emitters are simulated independently of each other, so they are spread
+    // over the thread pool
+    emitters.parallel_for_each(
+        [this, &scene](ParticleEmitter& emitter) {
+            // Check if we need to continue spawning particles
 
-        std::size_t new_particles = particles_to_spawn(
-            emitter.time_since_last_spawn, 1.0f / emitter.emission.spawn_rate,
-            Time::deltaTime);
+            std::size_t new_particles =
+                particles_to_spawn(emitter.time_since_last_spawn,
+                                   1.0f / emitter.emission.spawn_rate,
+                                   Time::deltaTime);
 
-        if (!emitter.emission.enabled) { new_particles = 0; }
-        emitter.time_since_start += Time::deltaTime;
-        //#TODO: Move this to particles_to_spawn()?
-        if (!emitter.main.enabled) {
-            new_particles = 0;
-        } else if (!emitter.main.loop) {
-            // Check if effect has stopped
-            if (emitter.time_since_start >= emitter.main.duration) {
+            if (!emitter.emission.enabled) { new_particles = 0; }
+            emitter.time_since_start += Time::deltaTime;
+            //#TODO: Move this to particles_to_spawn()?
+            if (!emitter.main.enabled) {
                 new_particles = 0;
+            } else if (!emitter.main.loop) {
+                // Check if effect has stopped
+                if (emitter.time_since_start >= emitter.main.duration) {
+                    new_particles = 0;
+                }
             }
-        }
-
-        if (emitter.particles.size() + new_particles >
-            emitter.main.max_particles) {
-            new_particles =
-                emitter.main.max_particles - emitter.particles.size();
-        }
 
-        // #MaybeOptimize Insertion/deletion of particles (maybe switch to
-        // std::list since no random access is needed?)
+            if (emitter.particles.size() + new_particles >
+                emitter.main.max_particles) {
+                new_particles =
+                    emitter.main.max_particles - emitter.particles.size();
+            }
 
-        // First step: spawn new particles
-        auto trans = make_absolute_transform(
-            emitter.entity->get_component<Components::Transform>());
+            // #MaybeOptimize Insertion/deletion of particles (maybe switch to
+            // std::list since no random access is needed?)
 
-        for (std::size_t i = 0; i < new_particles; ++i) {
-            spawn_particle(emitter, trans);
-        }
+            // First step: spawn new particles
+            auto const& transform =
+                scene.get_ecs().get_component<Transform const>(emitter.entity);
+            for (std::size_t i = 0; i < new_particles; ++i) {
+                spawn_particle(emitter, transform);
+            }
 
-        // Second step: update particles
-        for (std::size_t i = 0; i < emitter.particles.size(); ++i) {
-            update_particle(i, emitter);
-        }
+            // Second step: update particles
+            for (std::size_t i = 0; i < emitter.particles.size(); ++i) {
+                update_particle(i, emitter);
+            }
 
-        // Third step: delete 'dead' particles
-        remove_expired_particles(emitter);
-
-        // Final step: Update buffer data
-
-        if (!emitter.particles.empty()) {
-            emitter.particle_vao->update_buffer_data(
-                1, glm::value_ptr(emitter.particle_data.positions[0]),
-                3 * emitter.particle_data.positions.size());
-            // Sizes
-            emitter.particle_vao->update_buffer_data(
-                2, glm::value_ptr(emitter.particle_data.sizes[0]),
-                3 * emitter.particle_data.sizes.size());
-            // Colors
-            emitter.particle_vao->update_buffer_data(
-                3, glm::value_ptr(emitter.particle_data.colors[0]),
-                4 * emitter.particle_data.colors.size());
-        }
-    }
+            // Third step: delete 'dead' particles
+            remove_expired_particles(emitter);
+        },
+        16);
+    // The particle data is uploaded by the renderer
 }
 
 //#CHECK: Make particle erase itself in update_particle() for better
@@ -120,14 +107,17 @@ void ParticleSystem::remove_expired_particles(
     }
 }
 
-void ParticleSystem::spawn_particle(
-    Components::ParticleEmitter& emitter,
-    Components::Transform const& abs_transform) {
+void ParticleSystem::spawn_particle(Components::ParticleEmitter& emitter,
+                                    Components::Transform const& transform) {
     using namespace Components;
 
+    // World space rotation and position as of the last transform hierarchy
+    // update
+    auto const& rotation = transform.world_rotation;
+    auto const world_position = glm::vec3(transform.world_matrix[3]);
+
     // #ParticleSystemTODO: Dependency on transform? Probably needed but not
     // great ...
-    auto& transform = emitter.entity->get_component<Transform>();
 
     ParticleEmitter::Particle particle;
     particle.life_left = emitter.main.start_lifetime;
@@ -142,33 +132,30 @@ void ParticleSystem::spawn_particle(
     switch (emitter.shape.shape) {
         case Components::ParticleEmitter::SpawnShape::Sphere:
             particle.direction = Math::direction_in_sphere(
-                emitter.shape.randomize_direction, abs_transform.rotation);
+                emitter.shape.randomize_direction, rotation);
             position += Math::position_on_sphere(*emitter.shape.radius);
             break;
         case ParticleEmitter::SpawnShape::Hemisphere:
             particle.direction = Math::direction_in_hemisphere(
-                emitter.shape.randomize_direction, abs_transform.rotation);
-            position = Math::position_on_hemisphere(*emitter.shape.radius,
-                                                    abs_transform.rotation);
+                emitter.shape.randomize_direction, rotation);
+            position =
+                Math::position_on_hemisphere(*emitter.shape.radius, rotation);
             break;
         case Components::ParticleEmitter::SpawnShape::Cone:
             position = Math::position_on_circle(*emitter.shape.radius,
-                                                *emitter.shape.arc,
-                                                abs_transform.rotation);
+                                                *emitter.shape.arc, rotation);
             particle.direction = Math::direction_in_cone(
-                *emitter.shape.arc, *emitter.shape.angle,
-                abs_transform.rotation);
+                *emitter.shape.arc, *emitter.shape.angle, rotation);
             break;
         case Components::ParticleEmitter::SpawnShape::Box:
-            position = Math::position_in_box(emitter.shape.scale,
-                                             abs_transform.rotation);
+            position = Math::position_in_box(emitter.shape.scale, rotation);
             particle.direction = Math::direction_in_sphere(
-                emitter.shape.randomize_direction, abs_transform.rotation);
+                emitter.shape.randomize_direction, rotation);
             break;
     }
 
     // Update position to no longer use relative position to origin
-    position += abs_transform.position;
+    position += world_position;
 
     particle.velocity = emitter.main.start_velocity;
     emitter.particle_data.sizes.emplace_back(emitter.main.start_size, 1.0f);
@@ -8,14 +8,19 @@
 
 namespace Saturn::Systems {
 
-void RotatorSystem::on_update(Scene& scene) {
+void RotatorSystem::on_start(Scene& scene) {
     using namespace Components;
-    for (auto [transform, rotator] :
-         scene.get_ecs().select<Transform, Rotator>()) {
+    scene.get_ecs().register_query<Transform, Rotator const>();
+}
 
-        transform.rotation +=
-            rotator.euler_angles * rotator.speed * Time::deltaTime;
-    }
+void RotatorSystem::on_update(Scene& scene) {
+    using namespace Components;
+    scene.get_ecs().query<Transform, Rotator const>().parallel_for_each(
+        [](Transform& transform, Rotator const& rotator) {
+            auto const step = Math::euler_to_quat(
+                rotator.euler_angles * rotator.speed * Time::deltaTime);
+            transform.rotation = glm::normalize(transform.rotation * step);
+        });
 }
 
 } // namespace Saturn::Systems
@@ -0,0 +1,7 @@
+#include "Subsystems/ECS/persistent_query.hpp"
+
+namespace Saturn::detail {
+
+query_interface::~query_interface() {}
+
+} // namespace Saturn::detail
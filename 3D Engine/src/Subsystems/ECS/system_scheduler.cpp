@@ -0,0 +1,145 @@
+#include "Subsystems/ECS/system_scheduler.hpp"
+
+#include "Subsystems/JobSystem/JobSystem.hpp"
+
+namespace Saturn {
+
+void system_scheduler::add_system(Systems::SystemBase* system,
+                                  system_access access) {
+    node n{system, access, {}, 0};
+    // Every earlier system of the same stage this one conflicts with has to
+    // finish first. This keeps registration order as the order of
+    // conflicting systems.
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].access.stage == access.stage &&
+            conflicts(nodes[i].access, access)) {
+            nodes[i].dependents.push_back(nodes.size());
+            ++n.dependency_count;
+        }
+    }
+    nodes.push_back(std::move(n));
+}
+
+void system_scheduler::set_mode(mode m) { current_mode = m; }
+
+system_scheduler::mode system_scheduler::get_mode() const {
+    return current_mode;
+}
+
+void system_scheduler::run(Scene& scene,
+                           std::atomic<std::uint32_t>& tick,
+                           update_stage stage) {
+    if (system_count(stage) == 0) { return; }
+    frame_tick = &tick;
+    frame_stage = stage;
+    if (current_mode == mode::sequential) {
+        run_sequential(scene);
+    } else {
+        run_parallel(scene);
+    }
+    frame_tick = nullptr;
+}
+
+std::size_t system_scheduler::system_count(update_stage stage) const {
+    std::size_t count = 0;
+    for (auto const& n : nodes) {
+        if (n.access.stage == stage) { ++count; }
+    }
+    return count;
+}
+
+bool system_scheduler::conflicts(system_access const& a,
+                                 system_access const& b) {
+    if (a.exclusive || b.exclusive) { return true; }
+    return (a.writes & (b.reads | b.writes)) != 0 || (b.writes & a.reads) != 0;
+}
+
+void system_scheduler::run_sequential(Scene& scene) {
+    for (auto& n : nodes) {
+        if (n.access.stage == frame_stage) { run_system(*n.system, scene); }
+    }
+}
+
+void system_scheduler::run_system(Systems::SystemBase& system, Scene& scene) {
+    system.on_update(scene);
+    // Everything stamped by the system is at most the old value, so the
+    // system does not see its own changes the next time
+    system.last_run = frame_tick->fetch_add(1);
+}
+
+void system_scheduler::run_parallel(Scene& scene) {
+    // No point in handing work to other threads if there are none
+    if (JobSystem::worker_count() == 0) {
+        run_sequential(scene);
+        return;
+    }
+
+    auto const stage_size = system_count(frame_stage);
+    std::unique_lock lock(mutex);
+    frame_scene = &scene;
+    finished = 0;
+    error = nullptr;
+    pending_dependencies.resize(nodes.size());
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        if (nodes[i].access.stage != frame_stage) { continue; }
+        pending_dependencies[i] = nodes[i].dependency_count;
+        if (pending_dependencies[i] == 0) { push_ready(i); }
+    }
+
+    // The main thread takes part in the frame. It is the only thread that may
+    // run main thread systems, and helps out with queued jobs when it has
+    // nothing else to do.
+    while (finished != stage_size) {
+        if (!ready_main_thread.empty()) {
+            auto index = ready_main_thread.front();
+            ready_main_thread.pop_front();
+            execute(index, lock);
+            continue;
+        }
+        lock.unlock();
+        bool const helped = JobSystem::run_pending_job();
+        lock.lock();
+        if (!helped && finished != stage_size && ready_main_thread.empty()) {
+            wake.wait(lock);
+        }
+    }
+    frame_scene = nullptr;
+
+    if (error) {
+        auto e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+}
+
+void system_scheduler::execute(std::size_t index,
+                               std::unique_lock<std::mutex>& lock) {
+    auto* system = nodes[index].system;
+    auto* scene = frame_scene;
+    lock.unlock();
+    std::exception_ptr system_error;
+    try {
+        run_system(*system, *scene);
+    } catch (...) { system_error = std::current_exception(); }
+    lock.lock();
+
+    if (system_error && !error) { error = system_error; }
+    for (auto dependent : nodes[index].dependents) {
+        if (--pending_dependencies[dependent] == 0) { push_ready(dependent); }
+    }
+    ++finished;
+    wake.notify_all();
+}
+
+void system_scheduler::push_ready(std::size_t index) {
+    if (nodes[index].access.main_thread_only) {
+        ready_main_thread.push_back(index);
+    } else {
+        JobSystem::schedule([this, index]() {
+            std::unique_lock lock(mutex);
+            execute(index, lock);
+        });
+    }
+}
+
+} // namespace Saturn
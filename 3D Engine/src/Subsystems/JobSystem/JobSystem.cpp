@@ -0,0 +1,403 @@
+#include "Subsystems/JobSystem/JobSystem.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+namespace Saturn {
+
+namespace detail {
+
+struct Job {
+    JobSystem::Function fn;
+    // Dependencies that are not done yet, plus one until scheduling is
+    // complete. The job is queued when this drops to zero.
+    std::atomic<std::size_t> pending{1};
+    // Set while holding mutex, so jobs being scheduled either see it or get
+    // added to dependents
+    std::atomic<bool> finished{false};
+
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Job>> dependents;
+    std::exception_ptr error;
+};
+
+} // namespace detail
+
+namespace {
+
+using JobPtr = std::shared_ptr<detail::Job>;
+
+// Jobs in a ring buffer. Unlike std::deque it keeps its memory, so pushing
+// and popping does not allocate once the queue was large enough.
+class JobQueue {
+public:
+    void push(JobPtr job) {
+        std::lock_guard lock(mutex);
+        if (count == slots.size()) { grow(); }
+        slots[(first + count) % slots.size()] = std::move(job);
+        ++count;
+    }
+
+    // Newest job, taken by the owning worker
+    JobPtr pop() {
+        std::lock_guard lock(mutex);
+        if (count == 0) { return nullptr; }
+        --count;
+        return std::move(slots[(first + count) % slots.size()]);
+    }
+
+    // Oldest job, taken by other threads
+    JobPtr steal() {
+        std::lock_guard lock(mutex);
+        if (count == 0) { return nullptr; }
+        auto job = std::move(slots[first]);
+        first = (first + 1) % slots.size();
+        --count;
+        return job;
+    }
+
+private:
+    void grow() {
+        std::vector<JobPtr> grown(std::max<std::size_t>(2 * slots.size(), 16));
+        for (std::size_t i = 0; i < count; ++i) {
+            grown[i] = std::move(slots[(first + i) % slots.size()]);
+        }
+        slots.swap(grown);
+        first = 0;
+    }
+
+    std::mutex mutex;
+    std::vector<JobPtr> slots;
+    std::size_t first = 0;
+    std::size_t count = 0;
+};
+
+constexpr std::size_t no_worker = static_cast<std::size_t>(-1);
+// Index of the worker running on this thread
+thread_local std::size_t current_worker = no_worker;
+
+// Rounds a worker looks for jobs before going to sleep. Keeps workers awake
+// between short jobs that are scheduled one after another.
+constexpr int spin_rounds = 64;
+
+struct State {
+    ~State() { stop(); }
+
+    void stop() {
+        {
+            std::lock_guard lock(sleep_mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& thread : threads) { thread.join(); }
+        threads.clear();
+        queues.clear();
+        stopping = false;
+    }
+
+    std::vector<std::unique_ptr<JobQueue>> queues;
+    JobQueue injected;
+    std::vector<std::thread> threads;
+
+    // Jobs in all queues
+    std::atomic<std::size_t> queued{0};
+    // Threads sleeping on wake, and how many of them wait for a job or loop
+    // to finish. Checked before notifying so the mutex is only taken when
+    // someone sleeps.
+    std::atomic<std::size_t> sleepers{0};
+    std::atomic<std::size_t> waiters{0};
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+State& state() {
+    static State instance;
+    return instance;
+}
+
+void enqueue(JobPtr job) {
+    auto& s = state();
+    if (current_worker < s.queues.size()) {
+        s.queues[current_worker]->push(std::move(job));
+    } else {
+        s.injected.push(std::move(job));
+    }
+    s.queued.fetch_add(1);
+    if (s.sleepers.load() != 0) {
+        { std::lock_guard lock(s.sleep_mutex); }
+        s.wake.notify_one();
+    }
+}
+
+// Wakes threads waiting for a job or a loop after it finished
+void notify_waiters() {
+    auto& s = state();
+    if (s.waiters.load() != 0) {
+        { std::lock_guard lock(s.sleep_mutex); }
+        s.wake.notify_all();
+    }
+}
+
+JobPtr find_job() {
+    auto& s = state();
+    if (s.queued.load(std::memory_order_relaxed) == 0) { return nullptr; }
+
+    auto const self = current_worker;
+    auto const worker_count = s.queues.size();
+    JobPtr job;
+    if (self < worker_count) { job = s.queues[self]->pop(); }
+    if (!job) { job = s.injected.steal(); }
+    for (std::size_t i = 1; !job && i <= worker_count; ++i) {
+        auto const victim = self < worker_count ? (self + i) % worker_count
+                                                : i - 1;
+        if (victim != self) { job = s.queues[victim]->steal(); }
+    }
+    if (job) { s.queued.fetch_sub(1); }
+    return job;
+}
+
+void release(JobPtr const& job) {
+    if (job->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        enqueue(job);
+    }
+}
+
+void execute(JobPtr const& job) {
+    if (!job->error) {
+        try {
+            job->fn();
+        } catch (...) { job->error = std::current_exception(); }
+    }
+    // Releases whatever the function captured
+    job->fn = nullptr;
+
+    std::vector<JobPtr> dependents;
+    {
+        std::lock_guard lock(job->mutex);
+        dependents.swap(job->dependents);
+        job->finished.store(true);
+    }
+    notify_waiters();
+
+    for (auto const& dependent : dependents) {
+        if (job->error) {
+            std::lock_guard lock(dependent->mutex);
+            if (!dependent->error) { dependent->error = job->error; }
+        }
+        release(dependent);
+    }
+}
+
+// Runs queued jobs until done returns true, sleeping when there are none
+template<typename F>
+void help_until(F&& done) {
+    auto& s = state();
+    while (!done()) {
+        if (auto job = find_job()) {
+            execute(job);
+            continue;
+        }
+        std::unique_lock lock(s.sleep_mutex);
+        s.sleepers.fetch_add(1);
+        s.waiters.fetch_add(1);
+        s.wake.wait(lock, [&]() { return done() || s.queued.load() != 0; });
+        s.waiters.fetch_sub(1);
+        s.sleepers.fetch_sub(1);
+    }
+}
+
+void worker_main(std::size_t index) {
+    current_worker = index;
+    auto& s = state();
+    while (true) {
+        JobPtr job;
+        for (int round = 0; !job && round < spin_rounds; ++round) {
+            job = find_job();
+            if (!job) { std::this_thread::yield(); }
+        }
+        if (job) {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock lock(s.sleep_mutex);
+        s.sleepers.fetch_add(1);
+        s.wake.wait(lock,
+                    [&s]() { return s.stopping || s.queued.load() != 0; });
+        s.sleepers.fetch_sub(1);
+        // Queued jobs are finished before shutting down
+        if (s.stopping && s.queued.load() == 0) { return; }
+    }
+}
+
+// Shared state of a single parallel_for call
+struct Loop {
+    std::size_t count;
+    std::size_t grain_size;
+    std::size_t range_count;
+    detail::RangeCallback fn;
+
+    std::atomic<std::size_t> next_range{0};
+
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    // Claims and runs ranges until there are none left
+    void work() {
+        std::size_t range;
+        while ((range = next_range.fetch_add(1)) < range_count) {
+            auto const begin = range * grain_size;
+            auto const end = std::min(begin + grain_size, count);
+            try {
+                fn.call(fn.fn, begin, end);
+            } catch (...) {
+                std::lock_guard lock(mutex);
+                if (!error) { error = std::current_exception(); }
+            }
+        }
+    }
+};
+
+// Helper jobs of the parallel_for calls on this thread. The first
+// loop_helpers_used are in use, the rest are finished and can be scheduled
+// again. A call nested in a loop takes the jobs above the outer call's.
+thread_local std::vector<JobPtr> loop_helpers;
+thread_local std::size_t loop_helpers_used = 0;
+
+JobPtr const& acquire_loop_helper() {
+    if (loop_helpers_used == loop_helpers.size()) {
+        loop_helpers.push_back(std::make_shared<detail::Job>());
+    }
+    auto const& job = loop_helpers[loop_helpers_used++];
+    job->pending.store(1);
+    job->finished.store(false);
+    job->error = nullptr;
+    return job;
+}
+
+} // namespace
+
+JobHandle::JobHandle(std::shared_ptr<detail::Job> job) : job(std::move(job)) {}
+
+bool JobHandle::valid() const { return job != nullptr; }
+
+bool JobHandle::done() const { return job && job->finished.load(); }
+
+void JobSystem::initialize() {
+    auto const hardware_threads = std::thread::hardware_concurrency();
+    initialize(hardware_threads > 1 ? hardware_threads - 1 : 0);
+}
+
+void JobSystem::initialize(std::size_t worker_count) {
+    auto& s = state();
+    s.stop();
+    for (std::size_t i = 0; i < worker_count; ++i) {
+        s.queues.push_back(std::make_unique<JobQueue>());
+    }
+    for (std::size_t i = 0; i < worker_count; ++i) {
+        s.threads.emplace_back(worker_main, i);
+    }
+}
+
+void JobSystem::shutdown() { state().stop(); }
+
+std::size_t JobSystem::worker_count() { return state().threads.size(); }
+
+JobHandle JobSystem::schedule(Function fn) {
+    return schedule(std::move(fn), {});
+}
+
+JobHandle JobSystem::schedule(Function fn,
+                              std::vector<JobHandle> const& dependencies) {
+    auto job = std::make_shared<detail::Job>();
+    job->fn = std::move(fn);
+    for (auto const& dependency : dependencies) {
+        if (!dependency.valid()) { continue; }
+        auto& parent = *dependency.job;
+        std::lock_guard lock(parent.mutex);
+        if (!parent.finished.load()) {
+            job->pending.fetch_add(1);
+            parent.dependents.push_back(job);
+        } else if (parent.error) {
+            // An earlier dependency may be passing on its error right now
+            std::lock_guard job_lock(job->mutex);
+            if (!job->error) { job->error = parent.error; }
+        }
+    }
+    // Drops the reference held while scheduling
+    release(job);
+    return JobHandle(std::move(job));
+}
+
+JobHandle JobSystem::then(JobHandle const& dependency, Function fn) {
+    return schedule(std::move(fn), {dependency});
+}
+
+void JobSystem::wait(JobHandle const& job) {
+    if (!job.valid()) { return; }
+    auto const& target = *job.job;
+    help_until([&target]() { return target.finished.load(); });
+    if (target.error) { std::rethrow_exception(target.error); }
+}
+
+void JobSystem::wait(std::vector<JobHandle> const& jobs) {
+    for (auto const& job : jobs) { wait(job); }
+}
+
+bool JobSystem::run_pending_job() {
+    auto job = find_job();
+    if (!job) { return false; }
+    execute(job);
+    return true;
+}
+
+void JobSystem::run_parallel_for(std::size_t count,
+                                 std::size_t grain_size,
+                                 detail::RangeCallback fn) {
+    if (count == 0) { return; }
+    grain_size = std::max<std::size_t>(grain_size, 1);
+    auto const range_count = (count + grain_size - 1) / grain_size;
+
+    auto const helpers = std::min(worker_count(), range_count - 1);
+    // Not worth involving other threads for a single range
+    if (helpers == 0) {
+        for (std::size_t begin = 0; begin < count; begin += grain_size) {
+            fn.call(fn.fn, begin, std::min(begin + grain_size, count));
+        }
+        return;
+    }
+
+    Loop loop;
+    loop.count = count;
+    loop.grain_size = grain_size;
+    loop.range_count = range_count;
+    loop.fn = fn;
+    auto const first_helper = loop_helpers_used;
+    for (std::size_t i = 0; i < helpers; ++i) {
+        auto const& job = acquire_loop_helper();
+        // A pointer fits into std::function without allocating
+        job->fn = [&loop]() { loop.work(); };
+        release(job);
+    }
+
+    loop.work();
+    // The loop lives on this stack frame, so every helper has to be done with
+    // it, not only every range. Helpers that start late find no ranges left
+    // and return right away. Jobs are only reused once execute marked them
+    // finished, after which it no longer touches them.
+    help_until([first_helper, helpers]() {
+        for (std::size_t i = first_helper; i < first_helper + helpers; ++i) {
+            if (!loop_helpers[i]->finished.load()) { return false; }
+        }
+        return true;
+    });
+    loop_helpers_used = first_helper;
+    if (loop.error) { std::rethrow_exception(loop.error); }
+}
+
+} // namespace Saturn
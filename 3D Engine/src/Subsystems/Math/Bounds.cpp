@@ -0,0 +1,259 @@
+#include "Subsystems/Math/Bounds.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define SATURN_BOUNDS_SSE2
+#    include <emmintrin.h>
+#endif
+
+namespace Saturn::Math {
+
+namespace {
+
+template<typename F>
+void for_each_position(std::vector<float> const& vertices,
+                       PositionLayout const& layout,
+                       F&& f) {
+    if (layout.stride == 0) { return; }
+    for (std::size_t base = 0;
+         base + layout.offset + layout.components <= vertices.size();
+         base += layout.stride) {
+        glm::vec3 position{0.0f, 0.0f, 0.0f};
+        for (std::size_t c = 0; c < layout.components; ++c) {
+            position[c] = vertices[base + layout.offset + c];
+        }
+        f(position);
+    }
+}
+
+glm::vec4 normalize_plane(glm::vec4 const& plane) {
+    float const length = std::sqrt(plane.x * plane.x + plane.y * plane.y +
+                                   plane.z * plane.z);
+    return {plane.x / length, plane.y / length, plane.z / length,
+            plane.w / length};
+}
+
+void push_lanes(Vec3Lanes& lanes, float x, float y, float z) {
+    lanes.x.push_back(x);
+    lanes.y.push_back(y);
+    lanes.z.push_back(z);
+}
+
+bool outside(glm::vec4 const& plane,
+             float x,
+             float y,
+             float z,
+             float extent) {
+    return plane.x * x + plane.y * y + plane.z * z + plane.w + extent < 0.0f;
+}
+
+bool outside_one(Frustum const& frustum,
+                 BoundsLanes const& bounds,
+                 std::size_t i) {
+    for (auto const& plane : frustum.planes) {
+        // Distance from the center to the box along the plane normal
+        float const box_radius = std::abs(plane.x) * bounds.extents.x[i] +
+                                 std::abs(plane.y) * bounds.extents.y[i] +
+                                 std::abs(plane.z) * bounds.extents.z[i];
+        if (outside(plane, bounds.center.x[i], bounds.center.y[i],
+                    bounds.center.z[i], box_radius) ||
+            outside(plane, bounds.sphere_center.x[i],
+                    bounds.sphere_center.y[i], bounds.sphere_center.z[i],
+                    bounds.radius[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+#ifdef SATURN_BOUNDS_SSE2
+
+// Signed distance of four points to plane
+__m128 plane_distance(glm::vec4 const& plane, __m128 x, __m128 y, __m128 z) {
+    return _mm_add_ps(
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), x),
+                   _mm_mul_ps(_mm_set1_ps(plane.y), y)),
+        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), z),
+                   _mm_set1_ps(plane.w)));
+}
+
+// outside_one for four bounds at once. Returns a bit mask with bit k set if
+// bounds i + k is outside.
+int outside_four(Frustum const& frustum,
+                 BoundsLanes const& bounds,
+                 std::size_t i) {
+    __m128 const cx = _mm_loadu_ps(&bounds.center.x[i]);
+    __m128 const cy = _mm_loadu_ps(&bounds.center.y[i]);
+    __m128 const cz = _mm_loadu_ps(&bounds.center.z[i]);
+    __m128 const ex = _mm_loadu_ps(&bounds.extents.x[i]);
+    __m128 const ey = _mm_loadu_ps(&bounds.extents.y[i]);
+    __m128 const ez = _mm_loadu_ps(&bounds.extents.z[i]);
+    __m128 const sx = _mm_loadu_ps(&bounds.sphere_center.x[i]);
+    __m128 const sy = _mm_loadu_ps(&bounds.sphere_center.y[i]);
+    __m128 const sz = _mm_loadu_ps(&bounds.sphere_center.z[i]);
+    __m128 const r = _mm_loadu_ps(&bounds.radius[i]);
+    __m128 const zero = _mm_setzero_ps();
+
+    __m128 out = zero;
+    for (auto const& plane : frustum.planes) {
+        __m128 const box_radius = _mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), ex),
+                       _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), ey)),
+            _mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), ez));
+        __m128 const box = _mm_add_ps(plane_distance(plane, cx, cy, cz),
+                                      box_radius);
+        __m128 const sphere =
+            _mm_add_ps(plane_distance(plane, sx, sy, sz), r);
+        out = _mm_or_ps(out, _mm_or_ps(_mm_cmplt_ps(box, zero),
+                                       _mm_cmplt_ps(sphere, zero)));
+    }
+    return _mm_movemask_ps(out);
+}
+
+#endif
+
+} // namespace
+
+AABB compute_aabb(std::vector<float> const& vertices,
+                  PositionLayout const& layout) {
+    AABB aabb;
+    bool first = true;
+    for_each_position(vertices, layout, [&](glm::vec3 const& position) {
+        for (int c = 0; c < 3; ++c) {
+            aabb.min[c] = first ? position[c] : std::min(aabb.min[c],
+                                                         position[c]);
+            aabb.max[c] = first ? position[c] : std::max(aabb.max[c],
+                                                         position[c]);
+        }
+        first = false;
+    });
+    return aabb;
+}
+
+BoundingSphere compute_bounding_sphere(std::vector<float> const& vertices,
+                                       PositionLayout const& layout,
+                                       AABB const& aabb) {
+    BoundingSphere sphere;
+    for (int c = 0; c < 3; ++c) {
+        sphere.center[c] = (aabb.min[c] + aabb.max[c]) * 0.5f;
+    }
+    float max_distance2 = 0.0f;
+    for_each_position(vertices, layout, [&](glm::vec3 const& position) {
+        float const dx = position.x - sphere.center.x;
+        float const dy = position.y - sphere.center.y;
+        float const dz = position.z - sphere.center.z;
+        max_distance2 = std::max(max_distance2, dx * dx + dy * dy + dz * dz);
+    });
+    sphere.radius = std::sqrt(max_distance2);
+    return sphere;
+}
+
+Frustum extract_frustum(glm::mat4 const& view_projection) {
+    auto const& m = view_projection;
+    // glm matrices are column major, so row i is the i-th element of every
+    // column
+    auto row = [&](int i) {
+        return glm::vec4(m[0][i], m[1][i], m[2][i], m[3][i]);
+    };
+    auto add = [](glm::vec4 const& a, glm::vec4 const& b, float sign) {
+        return glm::vec4(a.x + sign * b.x, a.y + sign * b.y, a.z + sign * b.z,
+                         a.w + sign * b.w);
+    };
+
+    glm::vec4 const w = row(3);
+    Frustum frustum;
+    for (int axis = 0; axis < 3; ++axis) {
+        frustum.planes[2 * axis] = normalize_plane(add(w, row(axis), 1.0f));
+        frustum.planes[2 * axis + 1] =
+            normalize_plane(add(w, row(axis), -1.0f));
+    }
+    return frustum;
+}
+
+void BoundsLanes::reserve(std::size_t count) {
+    for (auto* lanes : {&center, &extents, &sphere_center}) {
+        lanes->x.reserve(count);
+        lanes->y.reserve(count);
+        lanes->z.reserve(count);
+    }
+    radius.reserve(count);
+}
+
+void BoundsLanes::clear() {
+    for (auto* lanes : {&center, &extents, &sphere_center}) {
+        lanes->x.clear();
+        lanes->y.clear();
+        lanes->z.clear();
+    }
+    radius.clear();
+}
+
+void BoundsLanes::push_back(AABB const& aabb,
+                            BoundingSphere const& sphere,
+                            glm::mat4 const& model) {
+    auto const& m = model;
+    float local_center[3];
+    float local_extents[3];
+    for (int c = 0; c < 3; ++c) {
+        local_center[c] = (aabb.min[c] + aabb.max[c]) * 0.5f;
+        local_extents[c] = (aabb.max[c] - aabb.min[c]) * 0.5f;
+    }
+
+    // The world box encloses the transformed local box. Its extent along an
+    // axis is the sum of the local extents projected onto that axis.
+    float world_center[3];
+    float world_extents[3];
+    float world_sphere[3];
+    for (int row = 0; row < 3; ++row) {
+        world_center[row] = m[3][row];
+        world_extents[row] = 0.0f;
+        world_sphere[row] = m[3][row];
+        for (int col = 0; col < 3; ++col) {
+            world_center[row] += m[col][row] * local_center[col];
+            world_extents[row] += std::abs(m[col][row]) * local_extents[col];
+            world_sphere[row] += m[col][row] * sphere.center[col];
+        }
+    }
+
+    // Non uniform scale stretches the sphere by the largest axis scale
+    float max_scale2 = 0.0f;
+    for (int col = 0; col < 3; ++col) {
+        max_scale2 =
+            std::max(max_scale2, m[col][0] * m[col][0] +
+                                     m[col][1] * m[col][1] +
+                                     m[col][2] * m[col][2]);
+    }
+
+    push_lanes(center, world_center[0], world_center[1], world_center[2]);
+    push_lanes(extents, world_extents[0], world_extents[1], world_extents[2]);
+    push_lanes(sphere_center, world_sphere[0], world_sphere[1],
+               world_sphere[2]);
+    radius.push_back(sphere.radius * std::sqrt(max_scale2));
+}
+
+void cull_bounds(Frustum const& frustum,
+                 BoundsLanes const& bounds,
+                 std::vector<std::uint32_t>& visible) {
+    std::size_t const count = bounds.size();
+    std::size_t i = 0;
+#ifdef SATURN_BOUNDS_SSE2
+    for (; i + 4 <= count; i += 4) {
+        int const mask = outside_four(frustum, bounds, i);
+        for (int k = 0; k < 4; ++k) {
+            if (!(mask & (1 << k))) {
+                visible.push_back(static_cast<std::uint32_t>(i + k));
+            }
+        }
+    }
+#endif
+    for (; i < count; ++i) {
+        if (!outside_one(frustum, bounds, i)) {
+            visible.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+}
+
+} // namespace Saturn::Math
@@ -9,8 +9,6 @@
 
 namespace Saturn::Math {
 glm::vec3 random_direction(glm::vec3 const& base, float randomness) {
-    glm::vec3 direction = Math::spherical_to_cartesian(base);
-
     float r1 = Math::RandomEngine::get(0.0f, 1.0f);
     float r2 = Math::RandomEngine::get(0.0f, 1.0f);
     static constexpr float pi = Math::math_traits<float>::pi;
@@ -25,22 +23,21 @@ glm::vec3 random_direction(glm::vec3 const& base, float randomness) {
     glm::quat rotation =
         glm::rotation(glm::vec3{0.0f, 1.0f, 0.0f}, glm::vec3(x, y, z));
 
-    return Math::rotate_vector_by_quaternion(direction, rotation);
+    return Math::rotate_vector_by_quaternion(base, rotation);
 }
 
-glm::vec3 direction_in_sphere(float randomness,
-                              glm::vec3 const& base_rotation) {
-    const glm::vec3 base = Math::euler_to_spherical(base_rotation);
-    return random_direction(base, randomness);
+glm::vec3 direction_in_sphere(float randomness, glm::mat3 const& rotation) {
+    return random_direction(rotation[1], randomness);
 }
 
-glm::vec3 direction_in_hemisphere(float randomness, glm::vec3 base) {
+glm::vec3 direction_in_hemisphere(float randomness,
+                                  glm::mat3 const& rotation) {
     // Divide by 4 to transform given randomness for a full sphere to the
     // hemisphere
-    return random_direction(Math::euler_to_spherical(base), randomness / 4.0f);
+    return random_direction(rotation[1], randomness / 4.0f);
 }
 
-glm::vec3 direction_in_cone(float arc, float angle, glm::vec3 const& rotation) {
+glm::vec3 direction_in_cone(float arc, float angle, glm::mat3 const& rotation) {
     float r1 = Math::RandomEngine::get(0.0f, 1.0f);
     static constexpr float pi = Math::math_traits<float>::pi;
 
@@ -48,8 +45,7 @@ glm::vec3 direction_in_cone(float arc, float angle, glm::vec3 const& rotation) {
     float theta = glm::radians(angle);
     // Random phi value on our defined arc
     float phi = r1 * glm::radians(arc);
-    return Math::rotate_vector_by_quaternion(
-        Math::spherical_to_cartesian(1.0f, theta, phi), glm::quat(rotation));
+    return rotation * Math::spherical_to_cartesian(1.0f, theta, phi);
 }
 
 } // namespace Saturn::Math
@@ -5,6 +5,12 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#if defined(__SSE2__) || defined(_M_X64) ||                                   \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define SATURN_TRANSFORM_SSE2
+#    include <emmintrin.h>
+#endif
+
 namespace glm {
 
 mat4 rotate(mat4 const& mat, vec3 euler) {
@@ -31,4 +37,222 @@ glm::vec3 rotate_vector_by_quaternion(const glm::vec3& v, const glm::quat& q) {
            2.0f * s * glm::cross(u, v);
 }
 
+glm::quat euler_to_quat(glm::vec3 const& degrees) {
+    return glm::quat(glm::radians(degrees));
+}
+
+glm::vec3 quat_to_euler(glm::quat const& rotation) {
+    return glm::degrees(glm::eulerAngles(rotation));
+}
+
+namespace {
+
+void reserve_lanes(Vec3Lanes& lanes, std::size_t count) {
+    lanes.x.reserve(count);
+    lanes.y.reserve(count);
+    lanes.z.reserve(count);
+}
+
+void reserve_lanes(QuatLanes& lanes, std::size_t count) {
+    lanes.x.reserve(count);
+    lanes.y.reserve(count);
+    lanes.z.reserve(count);
+    lanes.w.reserve(count);
+}
+
+void resize_lanes(Vec3Lanes& lanes, std::size_t count, float value) {
+    lanes.x.resize(count, value);
+    lanes.y.resize(count, value);
+    lanes.z.resize(count, value);
+}
+
+void push_lanes(Vec3Lanes& lanes, glm::vec3 const& v) {
+    lanes.x.push_back(v.x);
+    lanes.y.push_back(v.y);
+    lanes.z.push_back(v.z);
+}
+
+void set_lanes(Vec3Lanes& lanes, std::size_t index, glm::vec3 const& v) {
+    lanes.x[index] = v.x;
+    lanes.y[index] = v.y;
+    lanes.z[index] = v.z;
+}
+
+glm::vec3 lanes_at(Vec3Lanes const& lanes, std::size_t index) {
+    return {lanes.x[index], lanes.y[index], lanes.z[index]};
+}
+
+// Builds the rotation matrix of the quaternion like glm::mat3_cast, and the
+// model matrix from it
+void compose_one(TransformLanes const& lanes,
+                 std::size_t i,
+                 glm::mat4& matrix,
+                 glm::mat3& rotation) {
+    float const x = lanes.rotation.x[i];
+    float const y = lanes.rotation.y[i];
+    float const z = lanes.rotation.z[i];
+    float const w = lanes.rotation.w[i];
+
+    rotation[0] = glm::vec3(1.0f - 2.0f * (y * y + z * z),
+                            2.0f * (x * y + w * z), 2.0f * (x * z - w * y));
+    rotation[1] = glm::vec3(2.0f * (x * y - w * z),
+                            1.0f - 2.0f * (x * x + z * z),
+                            2.0f * (y * z + w * x));
+    rotation[2] = glm::vec3(2.0f * (x * z + w * y), 2.0f * (y * z - w * x),
+                            1.0f - 2.0f * (x * x + y * y));
+
+    matrix[0] = glm::vec4(rotation[0] * lanes.scale.x[i], 0.0f);
+    matrix[1] = glm::vec4(rotation[1] * lanes.scale.y[i], 0.0f);
+    matrix[2] = glm::vec4(rotation[2] * lanes.scale.z[i], 0.0f);
+    matrix[3] = glm::vec4(lanes.position.x[i], lanes.position.y[i],
+                          lanes.position.z[i], 1.0f);
+}
+
+#ifdef SATURN_TRANSFORM_SSE2
+
+// Transposes four columns of four matrices, each register holding the same
+// element of every matrix, and stores column c of out[0..3]
+void store_column(
+    __m128 x, __m128 y, __m128 z, __m128 w, glm::mat4* out, int c) {
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(&out[0][c][0], x);
+    _mm_storeu_ps(&out[1][c][0], y);
+    _mm_storeu_ps(&out[2][c][0], z);
+    _mm_storeu_ps(&out[3][c][0], w);
+}
+
+// compose_one for four transforms at once
+void compose_four(TransformLanes const& lanes,
+                  std::size_t i,
+                  glm::mat4* matrices,
+                  glm::mat3* rotations) {
+    __m128 const x = _mm_loadu_ps(&lanes.rotation.x[i]);
+    __m128 const y = _mm_loadu_ps(&lanes.rotation.y[i]);
+    __m128 const z = _mm_loadu_ps(&lanes.rotation.z[i]);
+    __m128 const w = _mm_loadu_ps(&lanes.rotation.w[i]);
+    __m128 const one = _mm_set1_ps(1.0f);
+    __m128 const two = _mm_set1_ps(2.0f);
+
+    __m128 const xx = _mm_mul_ps(x, x);
+    __m128 const yy = _mm_mul_ps(y, y);
+    __m128 const zz = _mm_mul_ps(z, z);
+    __m128 const xy = _mm_mul_ps(x, y);
+    __m128 const xz = _mm_mul_ps(x, z);
+    __m128 const yz = _mm_mul_ps(y, z);
+    __m128 const wx = _mm_mul_ps(w, x);
+    __m128 const wy = _mm_mul_ps(w, y);
+    __m128 const wz = _mm_mul_ps(w, z);
+
+    // Element r[3 * column + row] of the rotation matrices
+    __m128 const r[9] = {
+        _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))),
+        _mm_mul_ps(two, _mm_add_ps(xy, wz)),
+        _mm_mul_ps(two, _mm_sub_ps(xz, wy)),
+        _mm_mul_ps(two, _mm_sub_ps(xy, wz)),
+        _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))),
+        _mm_mul_ps(two, _mm_add_ps(yz, wx)),
+        _mm_mul_ps(two, _mm_add_ps(xz, wy)),
+        _mm_mul_ps(two, _mm_sub_ps(yz, wx)),
+        _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)))};
+
+    // mat3 is not a multiple of four floats, so the rotations are
+    // transposed through memory
+    alignas(16) float elements[9][4];
+    for (int e = 0; e < 9; ++e) { _mm_store_ps(elements[e], r[e]); }
+    for (int k = 0; k < 4; ++k) {
+        for (int c = 0; c < 3; ++c) {
+            rotations[k][c] = glm::vec3(elements[3 * c][k],
+                                        elements[3 * c + 1][k],
+                                        elements[3 * c + 2][k]);
+        }
+    }
+
+    __m128 const zero = _mm_setzero_ps();
+    for (int c = 0; c < 3; ++c) {
+        __m128 const scale =
+            _mm_loadu_ps(c == 0   ? &lanes.scale.x[i]
+                         : c == 1 ? &lanes.scale.y[i]
+                                  : &lanes.scale.z[i]);
+        store_column(_mm_mul_ps(r[3 * c], scale),
+                     _mm_mul_ps(r[3 * c + 1], scale),
+                     _mm_mul_ps(r[3 * c + 2], scale), zero, matrices, c);
+    }
+    store_column(_mm_loadu_ps(&lanes.position.x[i]),
+                 _mm_loadu_ps(&lanes.position.y[i]),
+                 _mm_loadu_ps(&lanes.position.z[i]), one, matrices, 3);
+}
+
+#endif
+
+} // namespace
+
+void TransformLanes::reserve(std::size_t count) {
+    reserve_lanes(position, count);
+    reserve_lanes(rotation, count);
+    reserve_lanes(scale, count);
+}
+
+void TransformLanes::resize(std::size_t count) {
+    resize_lanes(position, count, 0.0f);
+    // Identity rotation
+    rotation.x.resize(count, 0.0f);
+    rotation.y.resize(count, 0.0f);
+    rotation.z.resize(count, 0.0f);
+    rotation.w.resize(count, 1.0f);
+    resize_lanes(scale, count, 1.0f);
+}
+
+void TransformLanes::clear() { resize(0); }
+
+void TransformLanes::push_back(glm::vec3 const& pos,
+                               glm::quat const& rot,
+                               glm::vec3 const& scl) {
+    push_lanes(position, pos);
+    rotation.x.push_back(rot.x);
+    rotation.y.push_back(rot.y);
+    rotation.z.push_back(rot.z);
+    rotation.w.push_back(rot.w);
+    push_lanes(scale, scl);
+}
+
+void TransformLanes::set(std::size_t index,
+                         glm::vec3 const& pos,
+                         glm::quat const& rot,
+                         glm::vec3 const& scl) {
+    set_lanes(position, index, pos);
+    rotation.x[index] = rot.x;
+    rotation.y[index] = rot.y;
+    rotation.z[index] = rot.z;
+    rotation.w[index] = rot.w;
+    set_lanes(scale, index, scl);
+}
+
+glm::vec3 TransformLanes::position_at(std::size_t index) const {
+    return lanes_at(position, index);
+}
+
+glm::quat TransformLanes::rotation_at(std::size_t index) const {
+    return glm::quat(rotation.w[index], rotation.x[index], rotation.y[index],
+                     rotation.z[index]);
+}
+
+glm::vec3 TransformLanes::scale_at(std::size_t index) const {
+    return lanes_at(scale, index);
+}
+
+void compose_model_matrices(TransformLanes const& lanes,
+                            glm::mat4* matrices,
+                            glm::mat3* rotations) {
+    std::size_t const count = lanes.size();
+    std::size_t i = 0;
+#ifdef SATURN_TRANSFORM_SSE2
+    for (; i + 4 <= count; i += 4) {
+        compose_four(lanes, i, matrices + i, rotations + i);
+    }
+#endif
+    for (; i < count; ++i) {
+        compose_one(lanes, i, matrices[i], rotations[i]);
+    }
+}
+
 } // namespace Saturn::Math
@@ -7,14 +7,22 @@ namespace Saturn {
 DepthMap::DepthMap(CreateInfo const& info) { assign(info); }
 
 DepthMap::~DepthMap() {
-    if (fbo != 0) { glDeleteFramebuffers(1, &fbo); }
-    if (texture != 0) { glDeleteTextures(1, &texture); }
+    auto& cache = GLStateCache::get();
+    if (fbo != 0) {
+        cache.forget_framebuffer(fbo);
+        glDeleteFramebuffers(1, &fbo);
+    }
+    if (texture != 0) {
+        cache.forget_texture(texture);
+        glDeleteTextures(1, &texture);
+    }
 }
 
 void DepthMap::assign(CreateInfo const& info) {
     // Create the texture
+    auto& cache = GLStateCache::get();
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    cache.bind_texture(GL_TEXTURE_2D, texture);
     // Internal format is GL_DEPTH_COMPONENT because we are making a depth map
     glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, info.dimensions.x,
                  info.dimensions.y, 0, GL_DEPTH_COMPONENT, GL_FLOAT, nullptr);
@@ -28,7 +36,7 @@ void DepthMap::assign(CreateInfo const& info) {
 
     // Create the framebuffer
     glGenFramebuffers(1, &fbo);
-    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    cache.bind_framebuffer(fbo);
     // Attach the depth map texture to the framebuffer
     glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D,
                            texture, 0);
@@ -36,20 +44,22 @@ void DepthMap::assign(CreateInfo const& info) {
     glDrawBuffer(GL_NONE);
     glReadBuffer(GL_NONE);
     // Unbind everything
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    cache.bind_framebuffer(0);
+    cache.bind_texture(GL_TEXTURE_2D, 0);
 }
 
 void DepthMap::bind_framebuffer(DepthMap& map) {
-    glBindFramebuffer(GL_FRAMEBUFFER, map.fbo);
+    GLStateCache::get().bind_framebuffer(map.fbo);
 }
 
-void DepthMap::unbind_framebuffer() { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+void DepthMap::unbind_framebuffer() { GLStateCache::get().bind_framebuffer(0); }
 
 void DepthMap::bind_texture(DepthMap& map) {
-    glBindTexture(GL_TEXTURE_2D, map.texture);
+    GLStateCache::get().bind_texture(GL_TEXTURE_2D, map.texture);
 }
 
-void DepthMap::unbind_texture() { glBindTexture(GL_TEXTURE_2D, 0); }
+void DepthMap::unbind_texture() {
+    GLStateCache::get().bind_texture(GL_TEXTURE_2D, 0);
+}
 
 } // namespace Saturn
@@ -23,6 +23,7 @@ Framebuffer::Framebuffer(CreateInfo create_info) : size(create_info.size) {
 }
 
 Framebuffer::~Framebuffer() {
+    forget_objects();
     glDeleteFramebuffers(1, &fbo);
     glDeleteRenderbuffers(1, &rbo);
     glDeleteTextures(1, &texture);
@@ -31,6 +32,7 @@ Framebuffer::~Framebuffer() {
 void Framebuffer::assign(CreateInfo create_info) {
     // Cleanup old framebuffer
     if (fbo != 0 && rbo != 0 && texture != 0) {
+        forget_objects();
         glDeleteFramebuffers(1, &fbo);
         glDeleteRenderbuffers(1, &rbo);
         glDeleteTextures(1, &texture);
@@ -52,10 +54,10 @@ void Framebuffer::assign(CreateInfo create_info) {
 }
 
 void Framebuffer::bind(Framebuffer& buf) {
-    glBindFramebuffer(GL_FRAMEBUFFER, buf.fbo);
+    GLStateCache::get().bind_framebuffer(buf.fbo);
 }
 
-void Framebuffer::unbind() { glBindFramebuffer(GL_FRAMEBUFFER, 0); }
+void Framebuffer::unbind() { GLStateCache::get().bind_framebuffer(0); }
 
 ImgDim Framebuffer::dimensions() const { return size; }
 
@@ -76,7 +78,7 @@ void Framebuffer::create_rbo() {
 void Framebuffer::create_texture() {
     // Create the texture to render to and bind it
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    GLStateCache::get().bind_texture(GL_TEXTURE_2D, texture);
 
     // Make the texture empty
     glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, size.x, size.y, 0, GL_RGB,
@@ -86,7 +88,13 @@ void Framebuffer::create_texture() {
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     // We're done with the texture, so unbind it
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLStateCache::get().bind_texture(GL_TEXTURE_2D, 0);
+}
+
+void Framebuffer::forget_objects() {
+    auto& cache = GLStateCache::get();
+    cache.forget_framebuffer(fbo);
+    cache.forget_texture(texture);
 }
 
 void Framebuffer::check_complete() {
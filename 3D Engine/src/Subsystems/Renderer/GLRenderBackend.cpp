@@ -0,0 +1,125 @@
+#include "Subsystems/Renderer/GLRenderBackend.hpp"
+
+#include "Subsystems/Renderer/DepthMap.hpp"
+#include "Subsystems/Renderer/Framebuffer.hpp"
+#include "Subsystems/Renderer/GLStateCache.hpp"
+#include "Subsystems/Renderer/OpenGL.hpp"
+#include "Subsystems/Renderer/Shader.hpp"
+#include "Subsystems/Renderer/Texture.hpp"
+#include "Subsystems/Renderer/UniformBuffer.hpp"
+#include "Subsystems/Renderer/VertexArray.hpp"
+
+namespace Saturn {
+
+void GLRenderBackend::bind_framebuffer(Framebuffer& framebuffer) {
+    Framebuffer::bind(framebuffer);
+}
+
+void GLRenderBackend::unbind_framebuffer() { Framebuffer::unbind(); }
+
+void GLRenderBackend::bind_depth_map_framebuffer(DepthMap& depth_map) {
+    DepthMap::bind_framebuffer(depth_map);
+}
+
+void GLRenderBackend::set_viewport(unsigned int x,
+                                   unsigned int y,
+                                   unsigned int w,
+                                   unsigned int h) {
+    glViewport(x, y, w, h);
+}
+
+void GLRenderBackend::set_clear_color(glm::vec4 const& color) {
+    glClearColor(color.x, color.y, color.z, color.w);
+}
+
+void GLRenderBackend::clear(unsigned int flags) { glClear(flags); }
+
+void GLRenderBackend::enable(unsigned int capability) {
+    GLStateCache::get().enable(capability);
+}
+
+void GLRenderBackend::disable(unsigned int capability) {
+    GLStateCache::get().disable(capability);
+}
+
+void GLRenderBackend::cull_face(unsigned int face) {
+    GLStateCache::get().cull_face(face);
+}
+
+void GLRenderBackend::blend_func(unsigned int source,
+                                 unsigned int destination) {
+    GLStateCache::get().blend_func(source, destination);
+}
+
+void GLRenderBackend::active_texture(unsigned int unit) {
+    GLStateCache::get().active_texture(unit);
+}
+
+void GLRenderBackend::bind_texture(Texture& texture) { Texture::bind(texture); }
+
+void GLRenderBackend::unbind_texture(Texture& texture) {
+    Texture::unbind(texture);
+}
+
+void GLRenderBackend::bind_depth_texture(DepthMap& depth_map) {
+    DepthMap::bind_texture(depth_map);
+}
+
+void GLRenderBackend::unbind_depth_texture() { DepthMap::unbind_texture(); }
+
+void GLRenderBackend::bind_texture_2d(unsigned int handle) {
+    GLStateCache::get().bind_texture(GL_TEXTURE_2D, handle);
+}
+
+// The setters bind the shader themselves
+
+void GLRenderBackend::set_uniform(Shader& shader, int location, int value) {
+    shader.set_int(location, value);
+}
+
+void GLRenderBackend::set_uniform(Shader& shader, int location, float value) {
+    shader.set_float(location, value);
+}
+
+void GLRenderBackend::set_uniform(Shader& shader,
+                                  int location,
+                                  glm::mat4 const& value) {
+    shader.set_mat4(location, value);
+}
+
+void GLRenderBackend::update_uniform_buffer(UniformBuffer& buffer,
+                                            std::size_t byte_offset,
+                                            void const* data,
+                                            std::size_t size) {
+    buffer.set_data(data, size, byte_offset);
+}
+
+void GLRenderBackend::update_vertex_buffer(VertexArray& vertices,
+                                           std::size_t buffer_index,
+                                           float const* data,
+                                           std::size_t count) {
+    vertices.update_buffer_data(buffer_index, data, count);
+}
+
+void GLRenderBackend::draw_elements(Shader& shader, VertexArray& vertices) {
+    Shader::bind(shader);
+    VertexArray::bind(vertices);
+    glDrawElements(GL_TRIANGLES, vertices.index_size(), GL_UNSIGNED_INT,
+                   nullptr);
+}
+
+void GLRenderBackend::draw_elements_instanced(Shader& shader,
+                                              VertexArray& vertices,
+                                              std::size_t instances) {
+    Shader::bind(shader);
+    VertexArray::bind(vertices);
+    glDrawElementsInstanced(GL_TRIANGLES, vertices.index_size(),
+                            GL_UNSIGNED_INT, nullptr, instances);
+}
+
+void GLRenderBackend::finish() {
+    Shader::unbind();
+    VertexArray::unbind();
+}
+
+} // namespace Saturn
@@ -0,0 +1,238 @@
+#include "Subsystems/Renderer/GLStateCache.hpp"
+
+namespace Saturn {
+
+GLStateCache::GLStateCache(Functions const& functions) : gl(functions) {
+    invalidate();
+}
+
+GLStateCache::Functions GLStateCache::gl_functions() {
+    // glad loads the functions at runtime, so they are wrapped instead of
+    // taking the address of the function pointers
+    Functions functions;
+    functions.use_program = [](GLuint program) { glUseProgram(program); };
+    functions.bind_vertex_array = [](GLuint vertex_array) {
+        glBindVertexArray(vertex_array);
+    };
+    functions.active_texture = [](GLenum unit) { glActiveTexture(unit); };
+    functions.bind_texture = [](GLenum target, GLuint texture) {
+        glBindTexture(target, texture);
+    };
+    functions.bind_buffer = [](GLenum target, GLuint buffer) {
+        glBindBuffer(target, buffer);
+    };
+    functions.bind_buffer_base = [](GLenum target, GLuint index,
+                                    GLuint buffer) {
+        glBindBufferBase(target, index, buffer);
+    };
+    functions.bind_framebuffer = [](GLenum target, GLuint framebuffer) {
+        glBindFramebuffer(target, framebuffer);
+    };
+    functions.enable = [](GLenum capability) { glEnable(capability); };
+    functions.disable = [](GLenum capability) { glDisable(capability); };
+    functions.blend_func = [](GLenum source, GLenum destination) {
+        glBlendFunc(source, destination);
+    };
+    functions.cull_face = [](GLenum face) { glCullFace(face); };
+    functions.depth_func = [](GLenum func) { glDepthFunc(func); };
+    return functions;
+}
+
+GLStateCache& GLStateCache::get() {
+    // Never destroyed, since GL objects owned by other statics forget their
+    // names when they are destroyed at exit
+    static GLStateCache* cache = new GLStateCache(gl_functions());
+    return *cache;
+}
+
+template<std::size_t N>
+std::size_t GLStateCache::index_of(std::array<GLenum, N> const& values,
+                                   GLenum value) {
+    for (std::size_t i = 0; i < N; ++i) {
+        if (values[i] == value) { return i; }
+    }
+    return N;
+}
+
+bool GLStateCache::change(GLuint& cached, GLuint value) {
+    if (cached == value) {
+        ++stats.filtered;
+        return false;
+    }
+    cached = value;
+    ++stats.issued;
+    return true;
+}
+
+void GLStateCache::pass_through() { ++stats.issued; }
+
+void GLStateCache::use_program(GLuint new_program) {
+    if (change(program, new_program)) { gl.use_program(new_program); }
+}
+
+void GLStateCache::bind_vertex_array(GLuint new_vertex_array) {
+    if (change(vertex_array, new_vertex_array)) {
+        gl.bind_vertex_array(new_vertex_array);
+        buffers[index_of(BufferTargets, GL_ELEMENT_ARRAY_BUFFER)] = Unknown;
+    }
+}
+
+void GLStateCache::active_texture(GLenum unit) {
+    if (change(active_unit, unit)) { gl.active_texture(unit); }
+}
+
+void GLStateCache::bind_texture(GLenum target, GLuint texture) {
+    std::size_t const unit = active_unit - GL_TEXTURE0;
+    std::size_t const slot = index_of(TextureTargets, target);
+    if (unit >= MaxTextureUnits || slot == TextureTargets.size()) {
+        // Without knowing the unit, every unit may have changed
+        if (active_unit == Unknown && slot < TextureTargets.size()) {
+            for (auto& bindings : textures) { bindings[slot] = Unknown; }
+        }
+        pass_through();
+        gl.bind_texture(target, texture);
+        return;
+    }
+    if (change(textures[unit][slot], texture)) {
+        gl.bind_texture(target, texture);
+    }
+}
+
+void GLStateCache::bind_texture(GLenum unit, GLenum target, GLuint texture) {
+    std::size_t const index = unit - GL_TEXTURE0;
+    std::size_t const slot = index_of(TextureTargets, target);
+    // Only switch units if the binding changes
+    if (index < MaxTextureUnits && slot < TextureTargets.size() &&
+        textures[index][slot] == texture) {
+        ++stats.filtered;
+        return;
+    }
+    active_texture(unit);
+    bind_texture(target, texture);
+}
+
+void GLStateCache::bind_buffer(GLenum target, GLuint buffer) {
+    std::size_t const slot = index_of(BufferTargets, target);
+    if (slot == BufferTargets.size()) {
+        pass_through();
+        gl.bind_buffer(target, buffer);
+        return;
+    }
+    if (change(buffers[slot], buffer)) { gl.bind_buffer(target, buffer); }
+}
+
+void GLStateCache::bind_buffer_base(GLenum target,
+                                    GLuint index,
+                                    GLuint buffer) {
+    std::size_t const slot = index_of(BufferTargets, target);
+    if (target != GL_UNIFORM_BUFFER || index >= MaxUniformBufferBindings) {
+        if (slot < BufferTargets.size()) { buffers[slot] = buffer; }
+        pass_through();
+        gl.bind_buffer_base(target, index, buffer);
+        return;
+    }
+    if (change(uniform_buffers[index], buffer)) {
+        gl.bind_buffer_base(target, index, buffer);
+        buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::bind_framebuffer(GLuint new_framebuffer) {
+    if (change(framebuffer, new_framebuffer)) {
+        gl.bind_framebuffer(GL_FRAMEBUFFER, new_framebuffer);
+    }
+}
+
+void GLStateCache::enable(GLenum capability) {
+    std::size_t const slot = index_of(Capabilities, capability);
+    if (slot == Capabilities.size()) {
+        pass_through();
+        gl.enable(capability);
+    } else if (change(capabilities[slot], 1)) {
+        gl.enable(capability);
+    }
+}
+
+void GLStateCache::disable(GLenum capability) {
+    std::size_t const slot = index_of(Capabilities, capability);
+    if (slot == Capabilities.size()) {
+        pass_through();
+        gl.disable(capability);
+    } else if (change(capabilities[slot], 0)) {
+        gl.disable(capability);
+    }
+}
+
+void GLStateCache::blend_func(GLenum source, GLenum destination) {
+    if (blend_source == source && blend_destination == destination) {
+        ++stats.filtered;
+        return;
+    }
+    blend_source = source;
+    blend_destination = destination;
+    pass_through();
+    gl.blend_func(source, destination);
+}
+
+void GLStateCache::cull_face(GLenum face) {
+    if (change(culled_face, face)) { gl.cull_face(face); }
+}
+
+void GLStateCache::depth_func(GLenum func) {
+    if (change(depth_function, func)) { gl.depth_func(func); }
+}
+
+void GLStateCache::forget_program(GLuint deleted) {
+    // A deleted program stays in use until another one is used, but its name
+    // may be reused by then
+    if (program == deleted) { program = Unknown; }
+}
+
+void GLStateCache::forget_vertex_array(GLuint deleted) {
+    if (vertex_array == deleted) {
+        vertex_array = 0;
+        buffers[index_of(BufferTargets, GL_ELEMENT_ARRAY_BUFFER)] = Unknown;
+    }
+}
+
+void GLStateCache::forget_texture(GLuint deleted) {
+    for (auto& unit : textures) {
+        for (auto& texture : unit) {
+            if (texture == deleted) { texture = 0; }
+        }
+    }
+}
+
+void GLStateCache::forget_buffer(GLuint deleted) {
+    for (auto& buffer : buffers) {
+        if (buffer == deleted) { buffer = 0; }
+    }
+    for (auto& buffer : uniform_buffers) {
+        if (buffer == deleted) { buffer = 0; }
+    }
+}
+
+void GLStateCache::forget_framebuffer(GLuint deleted) {
+    if (framebuffer == deleted) { framebuffer = 0; }
+}
+
+void GLStateCache::invalidate() {
+    program = Unknown;
+    vertex_array = Unknown;
+    framebuffer = Unknown;
+    active_unit = Unknown;
+    for (auto& unit : textures) { unit.fill(Unknown); }
+    buffers.fill(Unknown);
+    uniform_buffers.fill(Unknown);
+    capabilities.fill(Unknown);
+    blend_source = Unknown;
+    blend_destination = Unknown;
+    culled_face = Unknown;
+    depth_function = Unknown;
+}
+
+GLStateCache::Stats const& GLStateCache::get_stats() const { return stats; }
+
+void GLStateCache::reset_stats() { stats = {}; }
+
+} // namespace Saturn
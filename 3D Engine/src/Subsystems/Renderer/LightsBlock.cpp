@@ -0,0 +1,97 @@
+#include "Subsystems/Renderer/LightsBlock.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Saturn {
+
+// The offsets the std140 rules give for the GLSL declarations
+static_assert(LightsBlock::PointLightLayout.offsets[3] == 48);
+static_assert(LightsBlock::PointLightLayout.offsets[4] == 60);
+static_assert(LightsBlock::PointLightLayout.size == 64);
+static_assert(LightsBlock::DirectionalLightLayout.offsets[3] == 48);
+static_assert(LightsBlock::DirectionalLightLayout.size == 64);
+static_assert(LightsBlock::SpotLightLayout.offsets[4] == 64);
+// intensity is packed after the direction vec3
+static_assert(LightsBlock::SpotLightLayout.offsets[5] == 76);
+static_assert(LightsBlock::SpotLightLayout.offsets[6] == 80);
+static_assert(LightsBlock::SpotLightLayout.offsets[7] == 84);
+static_assert(LightsBlock::SpotLightLayout.size == 96);
+static_assert(LightsBlock::Layout.offsets[2] == 8);
+// The arrays start at the next multiple of 16 after the counts
+static_assert(LightsBlock::Layout.offsets[3] == 16);
+static_assert(LightsBlock::Layout.offsets[4] ==
+              16 + LightsBlock::MaxLightsPerType * 64);
+static_assert(LightsBlock::Layout.offsets[5] ==
+              16 + LightsBlock::MaxLightsPerType * 128);
+static_assert(LightsBlock::Layout.size ==
+              16 + LightsBlock::MaxLightsPerType * 224);
+
+void LightsBlock::assign(RenderFrame const& frame) {
+    auto const point_count =
+        std::min(frame.point_lights.size(), MaxLightsPerType);
+    auto const directional_count =
+        std::min(frame.directional_lights.size(), MaxLightsPerType);
+    auto const spot_count =
+        std::min(frame.spot_lights.size(), MaxLightsPerType);
+
+    write(Layout.offsets[0], static_cast<int>(point_count));
+    write(Layout.offsets[1], static_cast<int>(directional_count));
+    write(Layout.offsets[2], static_cast<int>(spot_count));
+
+    auto const& point = PointLightLayout;
+    for (std::size_t i = 0; i < point_count; ++i) {
+        auto const& light = frame.point_lights[i];
+        auto const base =
+            Layout.offsets[3] + i * std140::array_stride(point.type());
+        write(base + point.offsets[0], light.light.ambient);
+        write(base + point.offsets[1], light.light.diffuse);
+        write(base + point.offsets[2], light.light.specular);
+        write(base + point.offsets[3], light.position);
+        write(base + point.offsets[4], light.light.intensity);
+    }
+
+    auto const& directional = DirectionalLightLayout;
+    for (std::size_t i = 0; i < directional_count; ++i) {
+        auto const& light = frame.directional_lights[i];
+        auto const base =
+            Layout.offsets[4] + i * std140::array_stride(directional.type());
+        write(base + directional.offsets[0], light.ambient);
+        write(base + directional.offsets[1], light.diffuse);
+        write(base + directional.offsets[2], light.specular);
+        write(base + directional.offsets[3], light.direction);
+    }
+
+    auto const& spot = SpotLightLayout;
+    for (std::size_t i = 0; i < spot_count; ++i) {
+        auto const& light = frame.spot_lights[i];
+        auto const base =
+            Layout.offsets[5] + i * std140::array_stride(spot.type());
+        write(base + spot.offsets[0], light.light.ambient);
+        write(base + spot.offsets[1], light.light.diffuse);
+        write(base + spot.offsets[2], light.light.specular);
+        write(base + spot.offsets[3], light.position);
+        write(base + spot.offsets[4], light.light.direction);
+        write(base + spot.offsets[5], light.light.intensity);
+        // The shaders compare against the cosines of the angles
+        write(base + spot.offsets[6],
+              glm::cos(glm::radians(light.light.inner_angle)));
+        write(base + spot.offsets[7],
+              glm::cos(glm::radians(light.light.outer_angle)));
+    }
+}
+
+void LightsBlock::write(std::size_t offset, int value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+}
+
+void LightsBlock::write(std::size_t offset, float value) {
+    std::memcpy(bytes.data() + offset, &value, sizeof(value));
+}
+
+void LightsBlock::write(std::size_t offset, glm::vec3 const& value) {
+    float const components[3] = {value.x, value.y, value.z};
+    std::memcpy(bytes.data() + offset, components, sizeof(components));
+}
+
+} // namespace Saturn
@@ -1,13 +1,46 @@
 #include "Subsystems/Renderer/Mesh.hpp"
 
+#include <algorithm>
+
 namespace Saturn {
 
-Mesh::Mesh(CreateInfo const& create_info) : vertices(create_info.vertices) {}
+Mesh::Mesh(CreateInfo const& create_info) : vertices(create_info.vertices) {
+    compute_bounds(create_info.vertices);
+}
 
 void Mesh::assign(CreateInfo const& create_info) {
 	vertices.assign(create_info.vertices);
+    compute_bounds(create_info.vertices);
 }
 
 VertexArray& Mesh::get_vertices() { return vertices; }
 
+Math::AABB const& Mesh::get_aabb() const { return aabb; }
+
+Math::BoundingSphere const& Mesh::get_bounding_sphere() const {
+    return bounding_sphere;
+}
+
+void Mesh::compute_bounds(VertexArray::CreateInfo const& info) {
+    // The position is the attribute at location 0. Attributes are interleaved
+    // in the order they are listed.
+    Math::PositionLayout layout{0, 0, 0};
+    for (auto const& attribute : info.attributes) {
+        if (attribute.location_in_shader == 0) {
+            layout.offset = layout.stride;
+            layout.components = std::min<std::size_t>(
+                attribute.num_components, 3);
+        }
+        layout.stride += attribute.num_components;
+    }
+    if (layout.components == 0) {
+        aabb = {};
+        bounding_sphere = {};
+        return;
+    }
+    aabb = Math::compute_aabb(info.vertices, layout);
+    bounding_sphere =
+        Math::compute_bounding_sphere(info.vertices, layout, aabb);
+}
+
 } // namespace Saturn
\ No newline at end of file
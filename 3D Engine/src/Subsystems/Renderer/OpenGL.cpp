@@ -5,11 +5,14 @@ namespace Saturn {
 Vao::Vao() { glGenVertexArrays(1, &id); }
 
 Vao::~Vao() {
-    if (id != 0) { glDeleteVertexArrays(1, &id); }
+    if (id != 0) {
+        GLStateCache::get().forget_vertex_array(id);
+        glDeleteVertexArrays(1, &id);
+    }
 }
 
-void Vao::bind(Vao& vao) { glBindVertexArray(vao.id); }
+void Vao::bind(Vao& vao) { GLStateCache::get().bind_vertex_array(vao.id); }
 
-void Vao::unbind() { glBindVertexArray(0); }
+void Vao::unbind() { GLStateCache::get().bind_vertex_array(0); }
 
 } // namespace Saturn
@@ -0,0 +1,303 @@
+#include "Subsystems/Renderer/RenderCommandList.hpp"
+
+#include "Subsystems/Renderer/Viewport.hpp"
+
+#include <algorithm>
+
+namespace Saturn {
+
+RenderBackend::~RenderBackend() {}
+
+void RenderCommandList::reset() {
+    used = 0;
+    commands = 0;
+}
+
+bool RenderCommandList::empty() const { return commands == 0; }
+
+std::size_t RenderCommandList::command_count() const { return commands; }
+
+std::size_t RenderCommandList::size_bytes() const { return used; }
+
+void RenderCommandList::append(RenderCommandList const& other) {
+    if (other.empty()) { return; }
+    align_to(CommandAlignment);
+    write_bytes(other.data.data(), other.used);
+    commands += other.commands;
+}
+
+void RenderCommandList::bind_framebuffer(Framebuffer& framebuffer) {
+    write_op(Op::BindFramebuffer);
+    write(&framebuffer);
+}
+
+void RenderCommandList::unbind_framebuffer() {
+    write_op(Op::UnbindFramebuffer);
+}
+
+void RenderCommandList::bind_depth_map_framebuffer(DepthMap& depth_map) {
+    write_op(Op::BindDepthMapFramebuffer);
+    write(&depth_map);
+}
+
+void RenderCommandList::set_viewport(Viewport const& viewport) {
+    write_op(Op::SetViewport);
+    write(viewport.position());
+    write(viewport.dimensions());
+}
+
+void RenderCommandList::set_clear_color(glm::vec4 const& color) {
+    write_op(Op::SetClearColor);
+    write(color);
+}
+
+void RenderCommandList::clear(unsigned int flags) {
+    write_op(Op::Clear);
+    write(flags);
+}
+
+void RenderCommandList::enable(unsigned int capability) {
+    write_op(Op::Enable);
+    write(capability);
+}
+
+void RenderCommandList::disable(unsigned int capability) {
+    write_op(Op::Disable);
+    write(capability);
+}
+
+void RenderCommandList::cull_face(unsigned int face) {
+    write_op(Op::CullFace);
+    write(face);
+}
+
+void RenderCommandList::blend_func(unsigned int source,
+                                   unsigned int destination) {
+    write_op(Op::BlendFunc);
+    write(source);
+    write(destination);
+}
+
+void RenderCommandList::active_texture(unsigned int unit) {
+    write_op(Op::ActiveTexture);
+    write(unit);
+}
+
+void RenderCommandList::bind_texture(Texture& texture) {
+    write_op(Op::BindTexture);
+    write(&texture);
+}
+
+void RenderCommandList::unbind_texture(Texture& texture) {
+    write_op(Op::UnbindTexture);
+    write(&texture);
+}
+
+void RenderCommandList::bind_depth_texture(DepthMap& depth_map) {
+    write_op(Op::BindDepthTexture);
+    write(&depth_map);
+}
+
+void RenderCommandList::unbind_depth_texture() {
+    write_op(Op::UnbindDepthTexture);
+}
+
+void RenderCommandList::bind_texture_2d(unsigned int handle) {
+    write_op(Op::BindTexture2D);
+    write(handle);
+}
+
+void RenderCommandList::set_uniform(Shader& shader, int location, int value) {
+    write_op(Op::SetUniformInt);
+    write(&shader);
+    write(location);
+    write(value);
+}
+
+void RenderCommandList::set_uniform(Shader& shader,
+                                    int location,
+                                    float value) {
+    write_op(Op::SetUniformFloat);
+    write(&shader);
+    write(location);
+    write(value);
+}
+
+void RenderCommandList::set_uniform(Shader& shader,
+                                    int location,
+                                    glm::mat4 const& value) {
+    write_op(Op::SetUniformMat4);
+    write(&shader);
+    write(location);
+    write(value);
+}
+
+void RenderCommandList::update_uniform_buffer(UniformBuffer& buffer,
+                                              std::size_t byte_offset,
+                                              void const* src,
+                                              std::size_t size) {
+    write_op(Op::UpdateUniformBuffer);
+    write(&buffer);
+    write(byte_offset);
+    write(size);
+    write_bytes(src, size);
+}
+
+void RenderCommandList::update_vertex_buffer(VertexArray& vertices,
+                                             std::size_t buffer_index,
+                                             float const* src,
+                                             std::size_t count) {
+    write_op(Op::UpdateVertexBuffer);
+    write(&vertices);
+    write(buffer_index);
+    write(count);
+    // Aligned, so that replay can pass the floats on without copying them
+    static_assert(CommandAlignment % alignof(float) == 0);
+    align_to(alignof(float));
+    write_bytes(src, count * sizeof(float));
+}
+
+void RenderCommandList::draw_elements(Shader& shader, VertexArray& vertices) {
+    write_op(Op::DrawElements);
+    write(&shader);
+    write(&vertices);
+}
+
+void RenderCommandList::draw_elements_instanced(Shader& shader,
+                                                VertexArray& vertices,
+                                                std::size_t instances) {
+    write_op(Op::DrawElementsInstanced);
+    write(&shader);
+    write(&vertices);
+    write(instances);
+}
+
+void RenderCommandList::write_op(Op op) {
+    align_to(CommandAlignment);
+    write(op);
+    ++commands;
+}
+
+void RenderCommandList::write_bytes(void const* src, std::size_t size) {
+    if (size == 0) { return; }
+    std::memcpy(grow(size), src, size);
+}
+
+void RenderCommandList::reallocate(std::size_t min_size) {
+    data.resize(std::max(min_size, 2 * data.size()));
+}
+
+void RenderCommandList::align_to(std::size_t alignment) {
+    // The padding is never read
+    grow(aligned(used, alignment) - used);
+}
+
+std::size_t RenderCommandList::aligned(std::size_t pos,
+                                       std::size_t alignment) {
+    return (pos + alignment - 1) / alignment * alignment;
+}
+
+void RenderCommandList::replay(RenderBackend& backend) const {
+    std::size_t pos = 0;
+    while ((pos = aligned(pos, CommandAlignment)) < used) {
+        switch (read<Op>(pos)) {
+            case Op::BindFramebuffer:
+                backend.bind_framebuffer(*read<Framebuffer*>(pos));
+                break;
+            case Op::UnbindFramebuffer: backend.unbind_framebuffer(); break;
+            case Op::BindDepthMapFramebuffer:
+                backend.bind_depth_map_framebuffer(*read<DepthMap*>(pos));
+                break;
+            case Op::SetViewport: {
+                auto const position = read<WindowDim>(pos);
+                auto const size = read<WindowDim>(pos);
+                backend.set_viewport(position.x, position.y, size.x, size.y);
+                break;
+            }
+            case Op::SetClearColor:
+                backend.set_clear_color(read<glm::vec4>(pos));
+                break;
+            case Op::Clear: backend.clear(read<unsigned int>(pos)); break;
+            case Op::Enable: backend.enable(read<unsigned int>(pos)); break;
+            case Op::Disable: backend.disable(read<unsigned int>(pos)); break;
+            case Op::CullFace:
+                backend.cull_face(read<unsigned int>(pos));
+                break;
+            case Op::BlendFunc: {
+                auto const source = read<unsigned int>(pos);
+                auto const destination = read<unsigned int>(pos);
+                backend.blend_func(source, destination);
+                break;
+            }
+            case Op::ActiveTexture:
+                backend.active_texture(read<unsigned int>(pos));
+                break;
+            case Op::BindTexture:
+                backend.bind_texture(*read<Texture*>(pos));
+                break;
+            case Op::UnbindTexture:
+                backend.unbind_texture(*read<Texture*>(pos));
+                break;
+            case Op::BindDepthTexture:
+                backend.bind_depth_texture(*read<DepthMap*>(pos));
+                break;
+            case Op::UnbindDepthTexture: backend.unbind_depth_texture(); break;
+            case Op::BindTexture2D:
+                backend.bind_texture_2d(read<unsigned int>(pos));
+                break;
+            case Op::SetUniformInt: {
+                auto* shader = read<Shader*>(pos);
+                auto const location = read<int>(pos);
+                backend.set_uniform(*shader, location, read<int>(pos));
+                break;
+            }
+            case Op::SetUniformFloat: {
+                auto* shader = read<Shader*>(pos);
+                auto const location = read<int>(pos);
+                backend.set_uniform(*shader, location, read<float>(pos));
+                break;
+            }
+            case Op::SetUniformMat4: {
+                auto* shader = read<Shader*>(pos);
+                auto const location = read<int>(pos);
+                backend.set_uniform(*shader, location, read<glm::mat4>(pos));
+                break;
+            }
+            case Op::UpdateUniformBuffer: {
+                auto* buffer = read<UniformBuffer*>(pos);
+                auto const byte_offset = read<std::size_t>(pos);
+                auto const size = read<std::size_t>(pos);
+                backend.update_uniform_buffer(*buffer, byte_offset,
+                                              data.data() + pos, size);
+                pos += size;
+                break;
+            }
+            case Op::UpdateVertexBuffer: {
+                auto* vertices = read<VertexArray*>(pos);
+                auto const buffer_index = read<std::size_t>(pos);
+                auto const count = read<std::size_t>(pos);
+                pos = aligned(pos, alignof(float));
+                backend.update_vertex_buffer(
+                    *vertices, buffer_index,
+                    reinterpret_cast<float const*>(data.data() + pos), count);
+                pos += count * sizeof(float);
+                break;
+            }
+            case Op::DrawElements: {
+                auto* shader = read<Shader*>(pos);
+                backend.draw_elements(*shader, *read<VertexArray*>(pos));
+                break;
+            }
+            case Op::DrawElementsInstanced: {
+                auto* shader = read<Shader*>(pos);
+                auto* vertices = read<VertexArray*>(pos);
+                backend.draw_elements_instanced(*shader, *vertices,
+                                                read<std::size_t>(pos));
+                break;
+            }
+        }
+    }
+    backend.finish();
+}
+
+} // namespace Saturn
@@ -0,0 +1,78 @@
+#include "Subsystems/Renderer/RenderQueue.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace Saturn {
+
+namespace {
+
+constexpr std::uint64_t field(std::uint64_t value, int bits, int shift) {
+    return (value & ((std::uint64_t(1) << bits) - 1)) << shift;
+}
+
+} // namespace
+
+RenderQueue::Stats& RenderQueue::Stats::operator+=(Stats const& rhs) {
+    shader_switches += rhs.shader_switches;
+    texture_binds += rhs.texture_binds;
+    vertex_array_switches += rhs.vertex_array_switches;
+    return *this;
+}
+
+std::uint64_t RenderQueue::make_key(Pass pass,
+                                    std::uint32_t shader,
+                                    std::uint32_t material,
+                                    std::uint32_t mesh,
+                                    float depth) {
+    // Also maps NaN to 0
+    float const clamped = depth > 0.0f ? std::min(depth, 1.0f) : 0.0f;
+    auto const quantized = static_cast<std::uint64_t>(clamped * 0xFFFF);
+    return field(static_cast<std::uint64_t>(pass), 4, 60) |
+           field(shader, 12, 48) | field(material, 20, 28) |
+           field(mesh, 12, 16) | field(quantized, 16, 0);
+}
+
+void RenderQueue::clear() { queue.clear(); }
+
+void RenderQueue::push(std::uint64_t key, std::uint32_t index) {
+    queue.push_back({key, index});
+}
+
+void RenderQueue::sort() {
+    constexpr int Digits = sizeof(std::uint64_t);
+    std::size_t const count = queue.size();
+    if (count < 2) { return; }
+
+    // Histograms of all digits are counted in one pass over the keys
+    std::array<std::array<std::size_t, 256>, Digits> histograms{};
+    for (auto const& item : queue) {
+        for (int d = 0; d < Digits; ++d) {
+            ++histograms[d][(item.key >> (8 * d)) & 0xFF];
+        }
+    }
+
+    scratch.resize(count);
+    // Least significant digit first. Every pass is stable, so the order of
+    // the previous digits is kept within equal digits.
+    for (int d = 0; d < Digits; ++d) {
+        auto& histogram = histograms[d];
+        // Digits that are the same for every key do not change the order,
+        // which skips most of the key for small scenes
+        std::uint64_t const first_digit = (queue[0].key >> (8 * d)) & 0xFF;
+        if (histogram[first_digit] == count) { continue; }
+
+        std::size_t offset = 0;
+        for (auto& bucket : histogram) {
+            std::size_t const size = bucket;
+            bucket = offset;
+            offset += size;
+        }
+        for (auto const& item : queue) {
+            scratch[histogram[(item.key >> (8 * d)) & 0xFF]++] = item;
+        }
+        queue.swap(scratch);
+    }
+}
+
+} // namespace Saturn
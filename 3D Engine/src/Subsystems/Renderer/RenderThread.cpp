@@ -0,0 +1,72 @@
+#include "Subsystems/Renderer/RenderThread.hpp"
+
+#include "glad/glad.h"
+#include <GLFW/glfw3.h>
+
+#include <utility>
+
+namespace Saturn {
+
+RenderThread::RenderThread(GLFWwindow* window, DrawFunction draw) :
+    window(window), draw(std::move(draw)) {
+    // A context can only be current on one thread at a time
+    glfwMakeContextCurrent(nullptr);
+    thread = std::thread([this]() { run(); });
+}
+
+RenderThread::~RenderThread() {
+    {
+        std::unique_lock lock(mutex);
+        wait_idle(lock);
+        stopping = true;
+    }
+    wake.notify_all();
+    thread.join();
+    glfwMakeContextCurrent(window);
+}
+
+RenderCommandList& RenderThread::next_frame() { return frames[write_index]; }
+
+void RenderThread::submit() {
+    std::unique_lock lock(mutex);
+    wait_idle(lock);
+    if (error) {
+        auto e = error;
+        error = nullptr;
+        std::rethrow_exception(e);
+    }
+    in_flight = &frames[write_index];
+    // The other frame was drawn already, so it can be recorded into now.
+    // Resetting keeps its memory.
+    write_index = 1 - write_index;
+    frames[write_index].reset();
+    lock.unlock();
+    wake.notify_all();
+}
+
+void RenderThread::wait_idle(std::unique_lock<std::mutex>& lock) {
+    wake.wait(lock, [this]() { return in_flight == nullptr; });
+}
+
+void RenderThread::run() {
+    glfwMakeContextCurrent(window);
+    std::unique_lock lock(mutex);
+    while (true) {
+        wake.wait(lock, [this]() { return stopping || in_flight != nullptr; });
+        if (stopping) { break; }
+        auto const& frame = *in_flight;
+        lock.unlock();
+        std::exception_ptr draw_error;
+        try {
+            draw(frame);
+        } catch (...) { draw_error = std::current_exception(); }
+        lock.lock();
+        if (draw_error && !error) { error = draw_error; }
+        in_flight = nullptr;
+        wake.notify_all();
+    }
+    lock.unlock();
+    glfwMakeContextCurrent(nullptr);
+}
+
+} // namespace Saturn
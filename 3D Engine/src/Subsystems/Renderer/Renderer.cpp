@@ -2,18 +2,143 @@
 
 #include "Core/Application.hpp"
 #include "Subsystems/ECS/Components.hpp"
+#include "Subsystems/JobSystem/JobSystem.hpp"
 #include "Subsystems/Logging/LogSystem.hpp"
 #include "Subsystems/Math/Math.hpp"
 #include "Subsystems/Renderer/PostProcessing.hpp"
 #include "Subsystems/Scene/Scene.hpp"
 #include "Utility/Exceptions.hpp"
 #include "Utility/Utility.hpp"
-#include "Utility/bind_guard.hpp"
 
 #include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cmath>
+#include <type_traits>
 
 namespace Saturn {
 
+namespace {
+
+// Resources only point into the AssetManager, so a const component still
+// refers to a mutable GL object
+template<typename R>
+R* resource_ptr(Resource<R> const& resource) {
+    return const_cast<R*>(&resource.get());
+}
+
+// material is null for meshes without one
+RenderFrame::Mesh make_draw(Components::Transform const& transform,
+                            Components::StaticMesh const& mesh,
+                            Components::Material const* material) {
+    RenderFrame::Mesh draw{};
+    draw.model = transform.world_matrix;
+    draw.vertices = &resource_ptr(mesh.mesh)->get_vertices();
+    draw.face_cull = mesh.face_cull;
+    draw.has_material = material != nullptr;
+    if (material) {
+        draw.shader =
+            material->shader.is_loaded() ? resource_ptr(material->shader)
+                                         : nullptr;
+        draw.lit = material->lit;
+        if (!material->lit && material->texture.is_loaded() &&
+            material->shader.is_loaded()) {
+            draw.texture = resource_ptr(material->texture);
+        }
+        if (material->lit) {
+            draw.diffuse_map = resource_ptr(material->diffuse_map);
+            draw.specular_map = resource_ptr(material->specular_map);
+            draw.shininess = material->shininess;
+        }
+    }
+    return draw;
+}
+
+void extract_particles(Components::ParticleEmitter const& emitter,
+                       RenderFrame::ParticleBatch& batch) {
+    batch.vertices = resource_ptr(emitter.particle_vao);
+    batch.texture =
+        emitter.texture.is_loaded() ? resource_ptr(emitter.texture) : nullptr;
+    batch.additive = emitter.additive;
+    batch.count = emitter.particles.size();
+    // Assigning to existing batches keeps their memory
+    batch.positions.assign(emitter.particle_data.positions.begin(),
+                           emitter.particle_data.positions.end());
+    batch.sizes.assign(emitter.particle_data.sizes.begin(),
+                       emitter.particle_data.sizes.end());
+    batch.colors.assign(emitter.particle_data.colors.begin(),
+                        emitter.particle_data.colors.end());
+}
+
+// Appends the mesh and its world space bounds to out
+void add_mesh(RenderFrame& out,
+              Components::Transform const& transform,
+              Components::StaticMesh const& mesh,
+              Components::Material const* material) {
+    out.meshes.push_back(make_draw(transform, mesh, material));
+    auto const& resource = mesh.mesh.get();
+    out.bounds.push_back(resource.get_aabb(), resource.get_bounding_sphere(),
+                         transform.world_matrix);
+}
+
+// Textures bound for a mesh, null where there is none
+std::array<Texture*, 2> material_textures(RenderFrame::Mesh const& mesh) {
+    if (mesh.lit) { return {mesh.diffuse_map, mesh.specular_map}; }
+    return {mesh.texture, nullptr};
+}
+
+// Whether two meshes with the same shader need the same material state
+bool same_material(RenderFrame::Mesh const& a, RenderFrame::Mesh const& b) {
+    return a.lit == b.lit && a.texture == b.texture &&
+           a.diffuse_map == b.diffuse_map &&
+           a.specular_map == b.specular_map && a.shininess == b.shininess;
+}
+
+// Replaces the bound textures with next. Textures that stay bound are
+// skipped, and textures are only unbound if next does not bind their unit
+// anyway. Touching texture unit 2 unbinds the depth map. Returns the amount
+// of binds recorded.
+std::size_t switch_textures(std::array<Texture*, 2> const& bound,
+                            std::array<Texture*, 2> const& next,
+                            RenderCommandList& list,
+                            bool& depth_map_bound) {
+    auto contains = [](std::array<Texture*, 2> const& textures,
+                       Texture* texture) {
+        return texture == textures[0] || texture == textures[1];
+    };
+    auto uses_unit = [](std::array<Texture*, 2> const& textures, int unit) {
+        for (auto* texture : textures) {
+            if (texture && texture->unit() == unit) { return true; }
+        }
+        return false;
+    };
+
+    for (auto* texture : bound) {
+        if (!texture || contains(next, texture) ||
+            uses_unit(next, texture->unit())) {
+            continue;
+        }
+        list.unbind_texture(*texture);
+        if (texture->unit() == GL_TEXTURE2) { depth_map_bound = false; }
+    }
+    std::size_t binds = 0;
+    for (auto* texture : next) {
+        if (!texture || contains(bound, texture)) { continue; }
+        list.bind_texture(*texture);
+        ++binds;
+        if (texture->unit() == GL_TEXTURE2) { depth_map_bound = false; }
+    }
+    return binds;
+}
+
+// Returns the next batch of out, reusing the batches of the previous frame
+RenderFrame::ParticleBatch& next_batch(RenderFrame& out, std::size_t& count) {
+    if (count == out.particles.size()) { out.particles.emplace_back(); }
+    return out.particles[count++];
+}
+
+} // namespace
+
 static std::vector<float> screen_vertices = {
     // Vertices	        Texture coords
     -1.0f, 1.0f,  0.0f, 0.0f, 1.0f, // TL
@@ -39,6 +164,7 @@ void Renderer::create_default_viewport(CreateInfo const& create_info) {
         Viewport(0, 0, create_info.screen_size.x, create_info.screen_size.y));
     // Set it as the active viewport
     Viewport::set_active(get_viewport(0));
+    screen_viewport = get_viewport(0);
 }
 
 void Renderer::initialize_postprocessing() {
@@ -60,14 +186,7 @@ void Renderer::create_uniform_buffers() {
     lights_info.binding_point = 1;
     lights_info.dynamic =
         false; // for now, we assume lights are mostly static #CHECK
-    lights_info.size_in_bytes =
-        sizeof(int) +                           // point_light_count
-        sizeof(int) +                           // directional_light_count
-        sizeof(int) +                           // spot_light_count
-        LightSizesBytes::PaddingAfterSizeVars + // padding
-        MaxLightsPerType * (LightSizesBytes::PointLightGLSL +
-                            LightSizesBytes::DirectionalLightGLSL +
-                            LightSizesBytes::SpotLightGLSL);
+    lights_info.size_in_bytes = lights_block.size();
     lights_buffer.assign(lights_info);
 
     // Camera data buffer
@@ -88,6 +207,8 @@ void Renderer::load_default_shaders() {
         AssetManager<Shader>::get_resource("resources/shaders/particle.sh");
     depth_shader =
         AssetManager<Shader>::get_resource("resources/shaders/depth_map.sh");
+    default_particle_texture =
+        AssetManager<Texture>::get_resource("resources/textures/white.tex");
 }
 
 void Renderer::create_depth_map() {
@@ -113,185 +234,406 @@ void Renderer::clear(
     Color clear_color,
     GLenum flags /*= GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT*/) {
 
-    bind_guard<Framebuffer> framebuf_guard(framebuf);
-
-    glClearColor(clear_color.r, clear_color.g, clear_color.b, clear_color.a);
-    glClear(flags);
+    record_clear(commands, clear_color, flags);
+    replay_commands();
 }
 
 void Renderer::render_scene(Scene& scene) {
-    bind_guard<Framebuffer> framebuf_guard(framebuf);
+    extract_frame(scene, frame);
+    render_frame(frame);
+}
 
-    // Render every viewport
-    for (auto& vp : viewports) {
+void Renderer::extract_frame(Scene& scene, RenderFrame& out) {
+    using namespace Components;
+    auto& ecs = scene.ecs;
+
+    out.screen = get_viewport(0);
+    out.views.clear();
+    for (auto const& vp : viewports) {
+        // Skip viewports whose camera object was destroyed
+        if (!vp.has_camera() || !scene.is_alive(vp.get_camera())) continue;
+        auto const& camera = ecs.get_component<Camera const>(vp.get_camera());
+        auto const& cam_trans =
+            ecs.get_component<Transform const>(vp.get_camera());
+        out.views.push_back(
+            {vp, cam_trans.position, camera.front, camera.up, camera.fov});
+    }
+
+    out.meshes.clear();
+    out.bounds.clear();
+    // The renderer runs after all systems, so it can register its queries on
+    // first use. Later calls return the same, already up to date query.
+    auto& meshes = ecs.register_query<Transform const, StaticMesh const>();
+    out.meshes.reserve(meshes.size());
+    out.bounds.reserve(meshes.size());
+    for (auto [transform, mesh] : meshes) {
+        Material const* material = nullptr;
+        if (ecs.has_component<Material>(transform.entity)) {
+            material = &ecs.get_component<Material const>(transform.entity);
+        }
+        add_mesh(out, transform, mesh, material);
+    }
+
+    // Lights are needed for the shadow map every frame, but only uploaded
+    // again when they changed
+    extract_lights(scene, out);
+    out.lights_changed = lights_changed(scene, out);
+
+    std::size_t batch_count = 0;
+    for (auto [emitter] : ecs.register_query<ParticleEmitter const>()) {
+        extract_particles(emitter, next_batch(out, batch_count));
+    }
+    out.particles.resize(batch_count);
+
+    out.extracted_tick = ecs.advance_tick();
+}
+
+void Renderer::extract_frame(SceneSnapshot const& snapshot,
+                             std::vector<Viewport> const& viewports,
+                             RenderFrame& out) {
+    using namespace Components;
+    auto const& ecs = snapshot.ecs;
+    auto const& transforms = ecs.components<Transform>();
+
+    if (viewports.empty()) {
+        throw InvalidViewportException("Invalid viewport with index 0 "
+                                       "requested.");
+    }
+    out.screen = viewports[0];
+    out.views.clear();
+    for (auto const& vp : viewports) {
         if (!vp.has_camera()) continue;
-        // Render to depth map
-        render_to_depthmap(scene);
-        // Render viewport with depth map
-        render_viewport(scene, vp);
-    }
-}
-
-void Renderer::send_camera_matrices(Scene& scene,
-                                    Viewport& vp,
-                                    Components::Camera& camera) {
-    auto& cam_trans = camera.entity->get_component<Components::Transform>();
-    auto projection = glm::perspective(
-        glm::radians(camera.fov),
-        (float)vp.dimensions().x / (float)vp.dimensions().y, 0.1f, 100.0f);
-
-    auto view = glm::lookAt(cam_trans.position,
-                            cam_trans.position + camera.front, camera.up);
-
-    bind_guard<UniformBuffer> matrix_guard(matrix_buffer);
-    matrix_buffer.set_mat4(projection, 0);
-    matrix_buffer.set_mat4(view, sizeof(glm::mat4));
-
-    bind_guard<UniformBuffer> cam_guard(camera_buffer);
-    camera_buffer.set_vec3(cam_trans.position, 0);
-}
-
-void Renderer::send_lighting_data(Scene& scene) {
-    bind_guard<UniformBuffer> lights_guard(lights_buffer);
-    auto point_lights = collect_point_lights(scene);
-    lights_buffer.set_int(point_lights.size(), 0);
-    for (std::size_t i = 0; i < point_lights.size(); ++i) {
-        auto lightpos = point_lights[i]
-                            ->entity->get_component<Components::Transform>()
-                            .position;
-        // clang-format off
-        const auto point_light_offset =
-            sizeof(int) + // point_light_count
-			sizeof(int) + // directional_light_count
-			sizeof(int) + // spot_light_count
-			LightSizesBytes::PaddingAfterSizeVars +
-            i * (LightSizesBytes::PointLightGLSL); // point_lights array
-        // clang-format on
-        lights_buffer.set_vec3(point_lights[i]->ambient, point_light_offset);
-        lights_buffer.set_vec3(point_lights[i]->diffuse,
-                               point_light_offset + sizeof(glm::vec4));
-        lights_buffer.set_vec3(point_lights[i]->specular,
-                               point_light_offset + 2 * sizeof(glm::vec4));
-        lights_buffer.set_vec3(lightpos,
-                               point_light_offset + 3 * sizeof(glm::vec4));
-        lights_buffer.set_float(point_lights[i]->intensity,
-                                point_light_offset + 3 * sizeof(glm::vec4) +
-                                    sizeof(glm::vec3));
-    }
-
-    // TODO: Same for DirectionalLights and SpotLights, but with previous data
-    // size added to offset
-
-    constexpr std::size_t PointLightBaseOffset =
-        (sizeof(int) + sizeof(int) + sizeof(int) +
-         LightSizesBytes::PaddingAfterSizeVars +
-         MaxLightsPerType * (LightSizesBytes::PointLightGLSL));
-
-    auto directional_lights = collect_directional_lights(scene);
-    lights_buffer.set_int(directional_lights.size(), sizeof(int));
-    for (std::size_t i = 0; i < directional_lights.size(); ++i) {
-        const auto offset =
-            PointLightBaseOffset + i * (LightSizesBytes::DirectionalLightGLSL);
-        lights_buffer.set_vec3(directional_lights[i]->ambient, offset);
-        lights_buffer.set_vec3(directional_lights[i]->diffuse,
-                               offset + sizeof(glm::vec4));
-        lights_buffer.set_vec3(directional_lights[i]->specular,
-                               offset + 2 * sizeof(glm::vec4));
-        lights_buffer.set_vec3(directional_lights[i]->direction,
-                               offset + 3 * sizeof(glm::vec4));
-    }
-
-    constexpr std::size_t DirectionalLightBaseOffset =
-        MaxLightsPerType * LightSizesBytes::DirectionalLightGLSL;
-    constexpr std::size_t OffsetBeforeSpotLights =
-        PointLightBaseOffset + DirectionalLightBaseOffset;
-
-    auto spot_lights = collect_spot_lights(scene);
-    lights_buffer.set_int(spot_lights.size(), 2 * sizeof(int));
-    for (std::size_t i = 0; i < spot_lights.size(); ++i) {
-        const auto offset =
-            OffsetBeforeSpotLights + i * LightSizesBytes::SpotLightGLSL;
-        auto lightpos = spot_lights[i]
-                            ->entity->get_component<Components::Transform>()
-                            .position;
-        lights_buffer.set_vec3(spot_lights[i]->ambient, offset);
-        lights_buffer.set_vec3(spot_lights[i]->diffuse,
-                               offset + sizeof(glm::vec4));
-        lights_buffer.set_vec3(spot_lights[i]->specular,
-                               offset + 2 * sizeof(glm::vec4));
-        lights_buffer.set_vec3(lightpos, offset + 3 * sizeof(glm::vec4));
-        lights_buffer.set_vec3(spot_lights[i]->direction,
-                               offset + 4 * sizeof(glm::vec4));
-        lights_buffer.set_float(
-            spot_lights[i]->intensity,
-            offset + 4 * sizeof(glm::vec4) +
-                sizeof(glm::vec3)); // the first float is packed against the
-                                    // previous vec3
-        lights_buffer.set_float(
-            glm::cos(glm::radians(spot_lights[i]->inner_angle)),
-            offset + 5 * sizeof(glm::vec4));
-        lights_buffer.set_float(
-            glm::cos(glm::radians(spot_lights[i]->outer_angle)),
-            offset + 5 * sizeof(glm::vec4) + sizeof(float));
-    }
-}
-
-void Renderer::send_model_matrix(
-    Shader& shader, Components::Transform const& relative_transform) {
-    // Make sure to get absolute transform
-    auto transform = make_absolute_transform(relative_transform);
-
-    auto model = glm::mat4(1.0f);
-    // Apply transformations
-    model = glm::translate(model, transform.position);
-    model = glm::rotate(model, {glm::radians(transform.rotation.x),
-                                glm::radians(transform.rotation.y),
-                                glm::radians(transform.rotation.z)});
-    model = glm::scale(model, transform.scale);
-    // Send to shader
-    bind_guard<Shader> guard(shader);
-    shader.set_mat4(Shader::Uniforms::Model, model);
+        auto const* camera = ecs.components<Camera>().find(vp.get_camera());
+        auto const* cam_trans = transforms.find(vp.get_camera());
+        // Skip viewports whose camera object was destroyed
+        if (!camera || !cam_trans) continue;
+        out.views.push_back(
+            {vp, cam_trans->position, camera->front, camera->up, camera->fov});
+    }
+
+    out.meshes.clear();
+    out.bounds.clear();
+    auto const& materials = ecs.components<Material>();
+    for (auto const& mesh : ecs.components<StaticMesh>()) {
+        auto const* transform = transforms.find(mesh.entity);
+        if (!transform) { continue; }
+        add_mesh(out, *transform, mesh, materials.find(mesh.entity));
+    }
+
+    out.point_lights.clear();
+    for (auto const& light : ecs.components<PointLight>()) {
+        out.point_lights.push_back(
+            {light, transforms.get(light.entity).position});
+    }
+    out.directional_lights.assign(ecs.components<DirectionalLight>().begin(),
+                                  ecs.components<DirectionalLight>().end());
+    out.spot_lights.clear();
+    for (auto const& light : ecs.components<SpotLight>()) {
+        out.spot_lights.push_back(
+            {light, transforms.get(light.entity).position});
+    }
+    out.lights_changed = lights_changed(snapshot, out);
+
+    std::size_t batch_count = 0;
+    for (auto const& emitter : ecs.components<ParticleEmitter>()) {
+        extract_particles(emitter, next_batch(out, batch_count));
+    }
+    out.particles.resize(batch_count);
+
+    out.extracted_tick = snapshot.ecs.tick();
 }
 
-void Renderer::send_material_data(Shader& shader,
-                                  Components::Material& material) {
-
-    bind_guard<Shader> guard(shader);
-
-    if (material.lit) {
-        Texture::bind(material.diffuse_map.get());
-        shader.set_int(Shader::Uniforms::Material::DiffuseMap,
-                       material.diffuse_map->unit() - GL_TEXTURE0);
-        Texture::bind(material.specular_map.get());
-        shader.set_int(Shader::Uniforms::Material::SpecularMap,
-                       material.specular_map->unit() - GL_TEXTURE0);
-        shader.set_float(Shader::Uniforms::Material::Shininess,
-                         material.shininess);
-    } else if (material.texture.is_loaded() && material.shader.is_loaded()) {
-        // If there is a texture
-        Texture::bind(material.texture.get());
+void Renderer::render_frame(RenderFrame const& frame) {
+    record_frame(frame, commands);
+    replay_commands();
+}
+
+void Renderer::update_screen() {
+    record_screen_update(commands);
+    replay_commands();
+}
+
+void Renderer::record_clear(
+    RenderCommandList& list,
+    Color clear_color,
+    GLenum flags /*= GL_DEPTH_BUFFER_BIT | GL_COLOR_BUFFER_BIT*/) {
+
+    list.bind_framebuffer(framebuf);
+    list.set_clear_color(
+        {clear_color.r, clear_color.g, clear_color.b, clear_color.a});
+    list.clear(flags);
+    list.unbind_framebuffer();
+}
+
+void Renderer::record_frame(RenderFrame const& frame,
+                            RenderCommandList& list) {
+    list.bind_framebuffer(framebuf);
+    screen_viewport = frame.screen;
+    stats = {};
+
+    // Lighting data is the same for every viewport
+    if (frame.lights_changed) { send_lighting_data(frame, list); }
+
+    if (frame.views.empty()) {
+        list.unbind_framebuffer();
+        return;
+    }
+    build_context(frame, context);
+    // Particle instance data is the same for every view
+    upload_particles(frame, list);
+    // The depth map does not depend on the view, so all views share it
+    render_to_depthmap(frame, list);
+    for (std::size_t i = 0; i < frame.views.size(); ++i) {
+        render_viewport(frame, frame.views[i], context.views[i], list);
+    }
+    list.unbind_framebuffer();
+}
+
+void Renderer::record_scene(Scene& scene,
+                            RenderCommandList& list,
+                            Color clear_color) {
+    extract_frame(scene, frame);
+    record_clear(list, clear_color);
+    record_frame(frame, list);
+    // Copy framebuffer to screen
+    record_screen_update(list);
+}
+
+RenderBackend& Renderer::backend() { return gl_backend; }
+
+Renderer::Stats const& Renderer::get_stats() const { return stats; }
+
+void Renderer::build_context(RenderFrame const& frame, FrameContext& out) {
+    out.views.resize(frame.views.size());
+    for (std::size_t i = 0; i < frame.views.size(); ++i) {
+        auto& matrices = out.views[i];
+        matrices.projection = get_projection_matrix(frame.views[i]);
+        matrices.view = get_view_matrix(frame.views[i]);
+        matrices.view_projection = matrices.projection * matrices.view;
+    }
+    out.lightspace = get_lightspace_matrix(frame);
+    // Meshes outside the light volume cannot cast a shadow into the map
+    cull_meshes(frame, out.lightspace, out.shadow_casters);
+}
+
+void Renderer::cull_meshes(RenderFrame const& frame,
+                           glm::mat4 const& view_projection,
+                           std::vector<std::uint32_t>& visible) {
+    visible.clear();
+    Math::cull_bounds(Math::extract_frustum(view_projection), frame.bounds,
+                      visible);
+}
 
-        shader.set_int(Shader::Uniforms::Texture,
-                       material.texture->unit() - GL_TEXTURE0);
+std::uint64_t Renderer::sort_key(RenderQueue::Pass pass,
+                                  RenderFrame::Mesh const& mesh,
+                                  float depth) {
+    std::uint32_t shader = 0;
+    std::uint32_t material = 0;
+    // The shadow pass uses one shader and no textures
+    if (pass != RenderQueue::Pass::Shadow) {
+        shader = (mesh.shader ? *mesh.shader : no_shader_error.get()).handle();
+        // 10 bits of the handle of each texture
+        for (auto* texture : material_textures(mesh)) {
+            auto const handle = texture ? texture->handle() & 0x3FF : 0;
+            material = (material << 10) | handle;
+        }
+    }
+    return RenderQueue::make_key(pass, shader, material,
+                                 mesh.vertices->vao.id, depth);
+}
+
+template<typename F>
+void Renderer::record_queue(RenderCommandList& list, F&& record_range) {
+    auto const count = queue.size();
+    // Without workers, the lists would only add a copy
+    if (count <= MeshesPerRecordJob || JobSystem::worker_count() == 0) {
+        record_range(std::size_t(0), count, list, stats.state_changes);
+        return;
+    }
+
+    auto const job_count =
+        (count + MeshesPerRecordJob - 1) / MeshesPerRecordJob;
+    if (mesh_lists.size() < job_count) {
+        mesh_lists.resize(job_count);
+        mesh_list_stats.resize(job_count);
+    }
+    // parallel_for splits at multiples of the grain size, so every range
+    // maps to one list
+    JobSystem::parallel_for(
+        count, MeshesPerRecordJob, [&](std::size_t begin, std::size_t end) {
+            auto const job = begin / MeshesPerRecordJob;
+            mesh_lists[job].reset();
+            mesh_list_stats[job] = {};
+            record_range(begin, end, mesh_lists[job], mesh_list_stats[job]);
+        });
+    // Appending in order keeps the draw order of a serial loop
+    for (std::size_t i = 0; i < job_count; ++i) {
+        list.append(mesh_lists[i]);
+        stats.state_changes += mesh_list_stats[i];
+    }
+}
+
+void Renderer::replay_commands() {
+    commands.replay(gl_backend);
+    commands.reset();
+}
+
+glm::mat4 Renderer::get_projection_matrix(RenderFrame::View const& view) {
+    auto const& vp = view.viewport;
+    return glm::perspective(glm::radians(view.fov),
+                            (float)vp.dimensions().x / (float)vp.dimensions().y,
+                            NearPlane, FarPlane);
+}
+
+glm::mat4 Renderer::get_view_matrix(RenderFrame::View const& view) {
+    return glm::lookAt(view.position, view.position + view.front, view.up);
+}
+
+void Renderer::send_camera_matrices(RenderFrame::View const& view,
+                                    FrameContext::View const& matrices,
+                                    RenderCommandList& list) {
+    list.update_uniform_buffer(matrix_buffer, 0, matrices.projection);
+    list.update_uniform_buffer(matrix_buffer, sizeof(glm::mat4),
+                               matrices.view);
+
+    list.update_uniform_buffer(camera_buffer, 0, view.position);
+}
+
+bool Renderer::lights_changed(Scene& scene, RenderFrame& frame) {
+    using namespace Components;
+    auto& ecs = scene.ecs;
+    auto const since = frame.extracted_tick;
+
+    // Registered queries are reused every frame, unlike selects
+    auto& point_lights =
+        ecs.register_query<PointLight const, Transform const>();
+    auto& directional_lights = ecs.register_query<DirectionalLight const>();
+    auto& spot_lights = ecs.register_query<SpotLight const, Transform const>();
+    // Removing a light does not leave a change tick behind, but it changes
+    // the amount of lights
+    if (light_counts_changed({point_lights.size(), directional_lights.size(),
+                              spot_lights.size()},
+                             frame)) {
+        return true;
     }
+
+    // Added lights count as changed too, since adding sets the changed tick
+    auto changed = [&](auto const& light) {
+        using Light = std::decay_t<decltype(light)>;
+        return tick_newer(ecs.get_ticks<Light>(light.entity).changed, since);
+    };
+    auto moved = [&](auto const& light) {
+        return tick_newer(ecs.get_ticks<Transform>(light.entity).changed,
+                          since);
+    };
+    for (auto [light, transform] : point_lights) {
+        if (changed(light) || moved(light)) { return true; }
+    }
+    for (auto [light] : directional_lights) {
+        if (changed(light)) { return true; }
+    }
+    for (auto [light, transform] : spot_lights) {
+        if (changed(light) || moved(light)) { return true; }
+    }
+    return false;
+}
+
+bool Renderer::lights_changed(SceneSnapshot const& snapshot,
+                              RenderFrame& frame) {
+    using namespace Components;
+    auto const& ecs = snapshot.ecs;
+    auto const since = frame.extracted_tick;
+
+    auto const& point_lights = ecs.components<PointLight>();
+    auto const& directional_lights = ecs.components<DirectionalLight>();
+    auto const& spot_lights = ecs.components<SpotLight>();
+    if (light_counts_changed({point_lights.size(), directional_lights.size(),
+                              spot_lights.size()},
+                             frame)) {
+        return true;
+    }
+
+    auto const& transforms = ecs.components<Transform>();
+    auto moved = [&](auto const& lights) {
+        for (auto const& light : lights) {
+            auto const* ticks = transforms.find_ticks(light.entity);
+            if (ticks && tick_newer(ticks->changed, since)) { return true; }
+        }
+        return false;
+    };
+    return point_lights.any_changed(since) || moved(point_lights) ||
+           directional_lights.any_changed(since) ||
+           spot_lights.any_changed(since) || moved(spot_lights);
 }
 
-void Renderer::unbind_textures(Components::Material& material) {
-    if (material.texture.is_loaded() && material.shader.is_loaded()) {
-        Texture::unbind(material.texture.get());
+bool Renderer::light_counts_changed(std::array<std::size_t, 3> const& counts,
+                                    RenderFrame& frame) {
+    if (counts == frame.light_counts) { return false; }
+    frame.light_counts = counts;
+    return true;
+}
+
+void Renderer::extract_lights(Scene& scene, RenderFrame& out) {
+    using namespace Components;
+    auto& ecs = scene.ecs;
+
+    out.point_lights.clear();
+    for (auto [light, transform] :
+         ecs.register_query<PointLight const, Transform const>()) {
+        out.point_lights.push_back({light, transform.position});
+    }
+
+    out.directional_lights.clear();
+    for (auto [light] : ecs.register_query<DirectionalLight const>()) {
+        out.directional_lights.push_back(light);
     }
-    if (material.lit) {
-        Texture::unbind(material.diffuse_map.get());
-        Texture::unbind(material.specular_map.get());
+
+    out.spot_lights.clear();
+    for (auto [light, transform] :
+         ecs.register_query<SpotLight const, Transform const>()) {
+        out.spot_lights.push_back({light, transform.position});
     }
 }
 
-glm::mat4 Renderer::get_lightspace_matrix(Scene& scene) {
+void Renderer::send_lighting_data(RenderFrame const& frame,
+                                  RenderCommandList& list) {
+    // The whole block is uploaded with a single buffer update
+    lights_block.assign(frame);
+    list.update_uniform_buffer(lights_buffer, 0, lights_block.data(),
+                               lights_block.size());
+}
+
+void Renderer::send_model_matrix(Shader& shader,
+                                 glm::mat4 const& model,
+                                 RenderCommandList& list) {
+    // The world matrix already includes all parent transforms
+    list.set_uniform(shader, Shader::Uniforms::Model, model);
+}
+
+void Renderer::send_material_data(Shader& shader,
+                                  RenderFrame::Mesh const& mesh,
+                                  RenderCommandList& list) {
+
+    if (mesh.lit) {
+        list.set_uniform(shader, Shader::Uniforms::Material::DiffuseMap,
+                         mesh.diffuse_map->unit() - GL_TEXTURE0);
+        list.set_uniform(shader, Shader::Uniforms::Material::SpecularMap,
+                         mesh.specular_map->unit() - GL_TEXTURE0);
+        list.set_uniform(shader, Shader::Uniforms::Material::Shininess,
+                         mesh.shininess);
+    } else if (mesh.texture) {
+        // If there is a texture
+        list.set_uniform(shader, Shader::Uniforms::Texture,
+                         mesh.texture->unit() - GL_TEXTURE0);
+    }
+}
+
+glm::mat4 Renderer::get_lightspace_matrix(RenderFrame const& frame) {
     // For now, we only support one directional light for shadows
-    auto dirlights = collect_directional_lights(scene);
+    auto const& dirlights = frame.directional_lights;
     if (dirlights.empty())
         throw std::runtime_error("There must be a light"); // Temporary
-    auto& light = *dirlights[0];
+    auto const& light = dirlights[0];
     static constexpr float near_plane = 0.00001f;
     static constexpr float far_plane = 100.0f;
     // Orthographic projection for light
@@ -306,13 +648,13 @@ glm::mat4 Renderer::get_lightspace_matrix(Scene& scene) {
     return lightspace_mat;
 }
 
-void Renderer::render_to_depthmap(Scene& scene) {
-    using namespace Components;
-    DepthMap::bind_framebuffer(shadow_depth_map);
-    glActiveTexture(GL_TEXTURE2);
-    DepthMap::bind_texture(shadow_depth_map);
+void Renderer::render_to_depthmap(RenderFrame const& frame,
+                                  RenderCommandList& list) {
+    list.bind_depth_map_framebuffer(shadow_depth_map);
+    list.active_texture(GL_TEXTURE2);
+    list.bind_depth_texture(shadow_depth_map);
     // Clear the depth buffer
-    glClear(GL_DEPTH_BUFFER_BIT);
+    list.clear(GL_DEPTH_BUFFER_BIT);
     // Create a viewport for the depth map
     static Viewport depthmap_vp =
         Viewport(0, 0, DepthMapPrecision, DepthMapPrecision);
@@ -320,186 +662,249 @@ void Renderer::render_to_depthmap(Scene& scene) {
     // Render the scene to the depth map
 
     // We set the cull face to front for the depth map
-    glCullFace(GL_FRONT);
+    list.cull_face(GL_FRONT);
+
+    list.set_viewport(depthmap_vp);
+    auto& shader = depth_shader.get();
+    // The lightspace matrix is the same for every mesh
+    list.set_uniform(shader, Shader::Uniforms::LightSpaceMatrix,
+                     context.lightspace);
+
+    auto const& casters = context.shadow_casters;
+    stats.shadow_visible += casters.size();
+    stats.shadow_culled += frame.meshes.size() - casters.size();
+    // Only the mesh changes between shadow draws
+    queue.clear();
+    for (auto index : casters) {
+        queue.push(
+            sort_key(RenderQueue::Pass::Shadow, frame.meshes[index], 0.0f),
+            index);
+    }
+    queue.sort();
+    record_queue(list, [&](std::size_t begin, std::size_t end,
+                           RenderCommandList& out,
+                           RenderQueue::Stats& changes) {
+        record_shadow_draws(frame, begin, end, out, changes);
+    });
 
-    Viewport::set_active(depthmap_vp);
-    auto lightspace = get_lightspace_matrix(scene);
+    // Reset cull face
+    list.cull_face(GL_BACK);
 
-    for (auto [transform, mesh] : scene.ecs.select<Transform, StaticMesh>()) {
-        // Send model matrix
-        send_model_matrix(depth_shader.get(), transform);
+    list.unbind_depth_texture();
+    list.active_texture(GL_TEXTURE0);
+    // Rebind the framebuffer the depth map replaced
+    list.bind_framebuffer(framebuf);
+}
 
-        // Do the rendering
-        auto& vtx_array = mesh.mesh->get_vertices();
-        bind_guard<VertexArray> vao_guard(vtx_array);
-        bind_guard<Shader> shader_guard(depth_shader.get());
-        depth_shader->set_mat4(Shader::Uniforms::LightSpaceMatrix, lightspace);
-        glDrawElements(GL_TRIANGLES, vtx_array.index_size(), GL_UNSIGNED_INT,
-                       nullptr);
+void Renderer::render_viewport(RenderFrame const& frame,
+                               RenderFrame::View const& view,
+                               FrameContext::View const& matrices,
+                               RenderCommandList& list) {
+    list.set_viewport(view.viewport);
+
+    send_camera_matrices(view, matrices, list);
+
+    render_particles(frame, list); // #TODO: Check if it makes any difference
+                                   // if we render particles before or after
+                                   // the scene + figure out best option
+
+    cull_meshes(frame, matrices.view_projection, visible_meshes);
+    auto const& visible = visible_meshes;
+    stats.visible += visible.size();
+    stats.culled += frame.meshes.size() - visible.size();
+
+    // Sorting by state groups draws that share a shader and material, and
+    // orders each group front to back
+    queue.clear();
+    for (auto index : visible) {
+        auto const& mesh = frame.meshes[index];
+        if (!mesh.has_material) { continue; }
+        float const dx = frame.bounds.center.x[index] - view.position.x;
+        float const dy = frame.bounds.center.y[index] - view.position.y;
+        float const dz = frame.bounds.center.z[index] - view.position.z;
+        float const depth = std::sqrt(dx * dx + dy * dy + dz * dz) / FarPlane;
+        queue.push(sort_key(RenderQueue::Pass::Opaque, mesh, depth), index);
     }
+    queue.sort();
+
+    record_queue(list, [&](std::size_t begin, std::size_t end,
+                           RenderCommandList& out,
+                           RenderQueue::Stats& changes) {
+        record_opaque_draws(frame, begin, end, context.lightspace, out,
+                            changes);
+    });
+}
 
-    // Reset cull face
-    glCullFace(GL_BACK);
-
-    DepthMap::unbind_texture();
-    glActiveTexture(GL_TEXTURE0);
-    // Rebind other framebuffer afterwards to make sure the bind_guard from
-    // render_scene() doesn't break
-    Framebuffer::bind(framebuf);
-}
-
-void Renderer::render_viewport(Scene& scene, Viewport& vp) {
-    Viewport::set_active(vp);
-
-    auto cam_id = vp.get_camera();
-    auto& cam = scene.ecs.get_with_id<Components::Camera>(cam_id);
-    send_camera_matrices(scene, vp, cam);
-
-    send_lighting_data(scene);
-
-    render_particles(scene); // #TODO: Check if it makes any difference
-                             // if we render particles before or after
-                             // the scene + figure out best option
-
-    for (auto [relative_transform, mesh, material] :
-         scene.ecs.select<Components::Transform, Components::StaticMesh,
-                          Components::Material>()) {
-        auto& shader = material.shader.is_loaded() ? material.shader.get()
-                                                   : no_shader_error.get();
-
-        // Send data to shader
-        send_model_matrix(shader, relative_transform);
-        send_material_data(shader, material);
-
-        // Set lightspace matrix in shader
-        bind_guard<Shader> guard(shader);
-        if (material.lit) {
-            auto lightspace = get_lightspace_matrix(scene);
-            shader.set_mat4(Shader::Uniforms::LightSpaceMatrix, lightspace);
-            // Set shadow map in shader
-            glActiveTexture(GL_TEXTURE2);
-            DepthMap::bind_texture(shadow_depth_map);
-            shader.set_int(Shader::Uniforms::DepthMap, 2);
+void Renderer::record_shadow_draws(RenderFrame const& frame,
+                                   std::size_t begin,
+                                   std::size_t end,
+                                   RenderCommandList& list,
+                                   RenderQueue::Stats& changes) {
+    auto& shader = depth_shader.get();
+    VertexArray* vertices = nullptr;
+    for (std::size_t i = begin; i < end; ++i) {
+        auto const& mesh = frame.meshes[queue[i].index];
+        if (mesh.vertices != vertices) {
+            vertices = mesh.vertices;
+            ++changes.vertex_array_switches;
         }
-
-        // Do the actual rendering (maybe putt this in another function
-        // render_mesh() or something)
-        auto& vtx_array = mesh.mesh->get_vertices();
-
-        bind_guard<VertexArray> vao_guard(vtx_array);
-        if (!mesh.face_cull) { glDisable(GL_CULL_FACE); }
-        glDrawElements(GL_TRIANGLES, vtx_array.index_size(), GL_UNSIGNED_INT,
-                       nullptr);
-        if (!mesh.face_cull) { glEnable(GL_CULL_FACE); }
-        // Cleanup
-        unbind_textures(material);
-        glActiveTexture(GL_TEXTURE2);
-        DepthMap::unbind_texture();
+        send_model_matrix(shader, mesh.model, list);
+        list.draw_elements(shader, *mesh.vertices);
     }
 }
 
-//#MaybeTODO: Render particles with GL_POINTS if they're not textured?
-void Renderer::render_particles(Scene& scene) {
-    using namespace Components;
-    bind_guard<Shader> shader_guard(particle_shader.get());
+void Renderer::record_opaque_draws(RenderFrame const& frame,
+                                   std::size_t begin,
+                                   std::size_t end,
+                                   glm::mat4 const& lightspace,
+                                   RenderCommandList& list,
+                                   RenderQueue::Stats& changes) {
+    if (begin == end) { return; }
+
+    // State set up by the previous draws of the range
+    Shader* shader = nullptr;
+    RenderFrame::Mesh const* material = nullptr;
+    VertexArray* vertices = nullptr;
+    bool shadow_uniforms_sent = false;
+    bool depth_map_bound = false;
+    bool face_cull = true;
+
+    for (std::size_t i = begin; i < end; ++i) {
+        auto const& mesh = frame.meshes[queue[i].index];
+        auto& mesh_shader = mesh.shader ? *mesh.shader : no_shader_error.get();
+
+        bool const shader_changed = &mesh_shader != shader;
+        if (shader_changed) {
+            shader = &mesh_shader;
+            shadow_uniforms_sent = false;
+            ++changes.shader_switches;
+        }
+        // Uniforms belong to the shader, so a new shader needs them again
+        if (shader_changed || !material || !same_material(*material, mesh)) {
+            std::array<Texture*, 2> const bound =
+                material ? material_textures(*material)
+                         : std::array<Texture*, 2>{};
+            changes.texture_binds += switch_textures(
+                bound, material_textures(mesh), list, depth_map_bound);
+            send_material_data(*shader, mesh, list);
+            material = &mesh;
+        }
 
-    Resource<Texture> default_texture =
-        AssetManager<Texture>::get_resource("resources/textures/white.tex");
+        if (mesh.lit) {
+            if (!shadow_uniforms_sent) {
+                list.set_uniform(*shader, Shader::Uniforms::LightSpaceMatrix,
+                                 lightspace);
+                list.set_uniform(*shader, Shader::Uniforms::DepthMap, 2);
+                shadow_uniforms_sent = true;
+            }
+            if (!depth_map_bound) {
+                list.active_texture(GL_TEXTURE2);
+                list.bind_depth_texture(shadow_depth_map);
+                depth_map_bound = true;
+            }
+        }
 
-    glDisable(GL_CULL_FACE);
-    for (auto [emitter] : scene.ecs.select<ParticleEmitter>()) {
-        if (emitter.additive) { glBlendFunc(GL_SRC_ALPHA, GL_ONE); }
-        // Bind VAO
-        bind_guard<VertexArray> vao_guard(emitter.particle_vao.get());
-
-        //            particle_shader->set_vec3(Shader::Uniforms::Position,
-        //                                      particle.position);
-        //            particle_shader->set_vec3(
-        //                Shader::Uniforms::Scale,
-        //                glm::vec3(particle.size.x, particle.size.y, 0.0f));
-        auto& texture = emitter.texture.is_loaded() ? emitter.texture.get()
-                                                    : default_texture.get();
-        //            particle_shader->set_vec4(Shader::Uniforms::Color,
-        //            particle.color);
-        Texture::bind(texture);
-        particle_shader->set_int(Shader::Uniforms::Texture,
-                                 texture.unit() - GL_TEXTURE0);
-
-        glDrawElementsInstanced(
-            GL_TRIANGLES, emitter.particle_vao->index_size(), GL_UNSIGNED_INT,
-            nullptr, emitter.particles.size());
-
-        Texture::unbind(texture);
-
-        if (emitter.additive) {
-            // reset blend function to old one
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        if (mesh.vertices != vertices) {
+            vertices = mesh.vertices;
+            ++changes.vertex_array_switches;
+        }
+        if (mesh.face_cull != face_cull) {
+            face_cull = mesh.face_cull;
+            if (face_cull) {
+                list.enable(GL_CULL_FACE);
+            } else {
+                list.disable(GL_CULL_FACE);
+            }
         }
+
+        send_model_matrix(*shader, mesh.model, list);
+        list.draw_elements(*shader, *mesh.vertices);
     }
-    glEnable(GL_CULL_FACE);
-}
 
-std::vector<Components::PointLight*>
-Renderer::collect_point_lights(Scene& scene) {
-    std::vector<Components::PointLight*> result;
-    for (auto [light] : scene.ecs.select<Components::PointLight>()) {
-        result.push_back(&light);
+    // Cleanup
+    if (!face_cull) { list.enable(GL_CULL_FACE); }
+    for (auto* texture : material_textures(*material)) {
+        if (texture) { list.unbind_texture(*texture); }
     }
-    return result;
+    list.active_texture(GL_TEXTURE2);
+    list.unbind_depth_texture();
 }
 
-std::vector<Components::DirectionalLight*>
-Renderer::collect_directional_lights(Scene& scene) {
-    std::vector<Components::DirectionalLight*> result;
-    for (auto [light] : scene.ecs.select<Components::DirectionalLight>()) {
-        result.push_back(&light);
+void Renderer::upload_particles(RenderFrame const& frame,
+                                RenderCommandList& list) {
+    for (auto const& batch : frame.particles) {
+        if (batch.count == 0) { continue; }
+        auto& vao = *batch.vertices;
+        // Instance data is copied into the list, because the particle system
+        // may already be simulating the next frame when it is replayed
+        list.update_vertex_buffer(vao, 1, glm::value_ptr(batch.positions[0]),
+                                  3 * batch.positions.size());
+        list.update_vertex_buffer(vao, 2, glm::value_ptr(batch.sizes[0]),
+                                  3 * batch.sizes.size());
+        list.update_vertex_buffer(vao, 3, glm::value_ptr(batch.colors[0]),
+                                  4 * batch.colors.size());
     }
-    return result;
 }
 
-std::vector<Components::SpotLight*>
-Renderer::collect_spot_lights(Scene& scene) {
-    std::vector<Components::SpotLight*> result;
-    for (auto [light] : scene.ecs.select<Components::SpotLight>()) {
-        result.push_back(&light);
+//#MaybeTODO: Render particles with GL_POINTS if they're not textured?
+void Renderer::render_particles(RenderFrame const& frame,
+                                RenderCommandList& list) {
+    auto& shader = particle_shader.get();
+
+    list.disable(GL_CULL_FACE);
+    for (auto const& batch : frame.particles) {
+        auto& vao = *batch.vertices;
+
+        if (batch.additive) { list.blend_func(GL_SRC_ALPHA, GL_ONE); }
+
+        auto& texture =
+            batch.texture ? *batch.texture : default_particle_texture.get();
+        list.bind_texture(texture);
+        list.set_uniform(shader, Shader::Uniforms::Texture,
+                         texture.unit() - GL_TEXTURE0);
+
+        list.draw_elements_instanced(shader, vao, batch.count);
+
+        list.unbind_texture(texture);
+
+        if (batch.additive) {
+            // reset blend function to old one
+            list.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
     }
-    return result;
+    list.enable(GL_CULL_FACE);
 }
 
-void Renderer::update_screen() {
-    bind_guard<Framebuffer> framebuf_guard(screen_framebuf);
+void Renderer::record_screen_update(RenderCommandList& list) {
+    list.bind_framebuffer(screen_framebuf);
 
-    Viewport::set_active(get_viewport(0));
-
-    // Bind VAO
-    bind_guard<VertexArray> screen_guard(screen);
-    bind_guard<Ebo> ebo_guard(screen.ebo);
+    list.set_viewport(screen_viewport);
 
     // Temporarily disable some GL functionality
-    glDisable(GL_DEPTH_TEST);
-    glDisable(GL_CULL_FACE);
+    list.disable(GL_DEPTH_TEST);
+    list.disable(GL_CULL_FACE);
 
     // Enable gamma correction
-    glEnable(GL_FRAMEBUFFER_SRGB);
+    list.enable(GL_FRAMEBUFFER_SRGB);
 
     // Set (postprocessing) shader
-    bind_guard<Shader> shader_guard(
-        PostProcessing::get_instance().get_active().get());
+    auto& shader = PostProcessing::get_instance().get_active().get();
 
     // Render framebuffer texture to the screen
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, framebuf.texture);
+    list.active_texture(GL_TEXTURE0);
+    list.bind_texture_2d(framebuf.texture);
 
-    PostProcessing::get_instance().get_active()->set_int(
-        Shader::Uniforms::Texture, 0);
-    glDrawElements(GL_TRIANGLES, screen.index_size(), GL_UNSIGNED_INT, nullptr);
+    list.set_uniform(shader, Shader::Uniforms::Texture, 0);
+    list.draw_elements(shader, screen);
 
     // Re enable functionality
-    glEnable(GL_DEPTH_TEST);
-    glEnable(GL_CULL_FACE);
+    list.enable(GL_DEPTH_TEST);
+    list.enable(GL_CULL_FACE);
 
     // Disable gamma correction
-    glDisable(GL_FRAMEBUFFER_SRGB);
+    list.disable(GL_FRAMEBUFFER_SRGB);
+
+    list.unbind_framebuffer();
 }
 
 Viewport& Renderer::get_viewport(std::size_t index) {
@@ -510,6 +915,10 @@ Viewport& Renderer::get_viewport(std::size_t index) {
     return viewports[index];
 }
 
+std::vector<Viewport> const& Renderer::get_viewports() const {
+    return viewports;
+}
+
 std::size_t Renderer::add_viewport(Viewport vp) {
     viewports.push_back(vp);
     return viewports.size() - 1;
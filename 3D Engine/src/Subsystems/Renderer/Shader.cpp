@@ -6,6 +6,7 @@
 #include <string>
 
 #include "Subsystems/Logging/LogSystem.hpp"
+#include "Subsystems/Renderer/LightsBlock.hpp"
 #include "Subsystems/Renderer/OpenGL.hpp"
 
 #include "Utility/bind_guard.hpp"
@@ -14,6 +15,25 @@
 
 namespace Saturn {
 
+// Defines the engine constants the shaders share with the C++ side, so that
+// they cannot go out of sync. GLSL only allows them after the #version line.
+static std::string add_engine_defines(std::string source) {
+    std::string const defines = "#define MAX_LIGHTS_PER_TYPE " +
+                                std::to_string(LightsBlock::MaxLightsPerType) +
+                                "\n";
+    std::size_t position = 0;
+    if (source.compare(0, 8, "#version") == 0) {
+        position = source.find('\n');
+        if (position == std::string::npos) {
+            position = source.size();
+            source += '\n';
+        }
+        ++position;
+    }
+    source.insert(position, defines);
+    return source;
+}
+
 static unsigned int create_shader(const char* vtx_path, const char* frag_path) {
     using namespace std::literals::string_literals;
 
@@ -30,7 +50,7 @@ static unsigned int create_shader(const char* vtx_path, const char* frag_path) {
     std::stringstream buf;
     buf << file.rdbuf();
 
-    std::string vtx_source(buf.str());
+    std::string vtx_source = add_engine_defines(buf.str());
 
     file.close();
     buf = std::stringstream{}; // reset buffer
@@ -46,7 +66,7 @@ static unsigned int create_shader(const char* vtx_path, const char* frag_path) {
 
     buf << file.rdbuf();
 
-    std::string frag_source(buf.str());
+    std::string frag_source = add_engine_defines(buf.str());
 
     unsigned int vtx_shader, frag_shader;
     vtx_shader = glCreateShader(GL_VERTEX_SHADER);
@@ -120,7 +140,10 @@ static unsigned int create_shader(const char* vtx_path, const char* frag_path) {
 Shader::Shader(CreateInfo create_info) { assign(create_info); }
 
 void Shader::assign(CreateInfo create_info) {
-    if (program != 0) { glDeleteProgram(program); }
+    if (program != 0) {
+        GLStateCache::get().forget_program(program);
+        glDeleteProgram(program);
+    }
     program = create_shader(create_info.vtx_path.data(),
                             create_info.frag_path.data());
 }
@@ -192,7 +215,9 @@ int Shader::location(std::string_view name) {
     return loc_data;
 }
 
-void Shader::bind(Shader& shader) { glUseProgram(shader.program); }
-void Shader::unbind() { glUseProgram(0); }
+void Shader::bind(Shader& shader) {
+    GLStateCache::get().use_program(shader.program);
+}
+void Shader::unbind() { GLStateCache::get().use_program(0); }
 
 } // namespace Saturn
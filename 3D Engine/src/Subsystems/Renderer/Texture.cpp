@@ -30,7 +30,9 @@ void Texture::assign(CreateInfo const& create_info) {
     }
 
     glGenTextures(1, &texture_handle);
-    glBindTexture(static_cast<GLenum>(create_info.target), texture_handle);
+    GLStateCache::get().bind_texture(texture_unit,
+                                     static_cast<GLenum>(create_info.target),
+                                     texture_handle);
     for (ParameterInfo param : create_info.parameters) {
         glTexParameteri(static_cast<GLenum>(create_info.target),
                         static_cast<GLenum>(param.parameter),
@@ -51,17 +53,21 @@ void Texture::assign(CreateInfo const& create_info) {
 }
 
 Texture::~Texture() {
-    if (texture_handle != 0) { glDeleteTextures(1, &texture_handle); }
+    if (texture_handle != 0) {
+        GLStateCache::get().forget_texture(texture_handle);
+        glDeleteTextures(1, &texture_handle);
+    }
 }
 
 void Texture::bind(Texture& tex) {
-    glActiveTexture(tex.unit());
-    glBindTexture(static_cast<GLenum>(tex.target), tex.texture_handle);
+    GLStateCache::get().bind_texture(tex.texture_unit,
+                                     static_cast<GLenum>(tex.target),
+                                     tex.texture_handle);
 }
 
 void Texture::unbind(Texture& tex /* = TextureTarget::Texture2D*/) {
-    glActiveTexture(tex.unit());
-    glBindTexture(static_cast<GLenum>(tex.target), 0);
+    GLStateCache::get().bind_texture(tex.texture_unit,
+                                     static_cast<GLenum>(tex.target), 0);
 }
 
 void Texture::set_parameter(ParameterInfo param) {
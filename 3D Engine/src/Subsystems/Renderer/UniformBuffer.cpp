@@ -18,21 +18,30 @@ UniformBuffer::UniformBuffer(CreateInfo const& create_info) {
     }
 
     // Link our buffer to the requested binding point
-    glBindBufferBase(GL_UNIFORM_BUFFER, create_info.binding_point, ubo);
+    GLStateCache::get().bind_buffer_base(GL_UNIFORM_BUFFER,
+                                         create_info.binding_point, ubo);
 }
 
 UniformBuffer::~UniformBuffer() {
-    if (ubo != 0) glDeleteBuffers(1, &ubo);
+    if (ubo != 0) {
+        GLStateCache::get().forget_buffer(ubo);
+        glDeleteBuffers(1, &ubo);
+    }
 }
 
 void UniformBuffer::bind(UniformBuffer& buf) {
-    glBindBuffer(GL_UNIFORM_BUFFER, buf.ubo);
+    GLStateCache::get().bind_buffer(GL_UNIFORM_BUFFER, buf.ubo);
 }
 
-void UniformBuffer::unbind() { glBindBuffer(GL_UNIFORM_BUFFER, 0); }
+void UniformBuffer::unbind() {
+    GLStateCache::get().bind_buffer(GL_UNIFORM_BUFFER, 0);
+}
 
 void UniformBuffer::assign(CreateInfo const& create_info) {
-    if (ubo != 0) glDeleteBuffers(1, &ubo);
+    if (ubo != 0) {
+        GLStateCache::get().forget_buffer(ubo);
+        glDeleteBuffers(1, &ubo);
+    }
 
     glGenBuffers(1, &ubo);
 
@@ -43,7 +52,8 @@ void UniformBuffer::assign(CreateInfo const& create_info) {
     }
 
     // Link our buffer to the requested binding point
-    glBindBufferBase(GL_UNIFORM_BUFFER, create_info.binding_point, ubo);
+    GLStateCache::get().bind_buffer_base(GL_UNIFORM_BUFFER,
+                                         create_info.binding_point, ubo);
 }
 
 void UniformBuffer::set_int(int value, std::size_t byte_offset) {
@@ -68,4 +78,11 @@ void UniformBuffer::set_mat4(glm::mat4 const& value, std::size_t byte_offset) {
                     glm::value_ptr(value));
 }
 
+void UniformBuffer::set_data(void const* data,
+                             std::size_t size,
+                             std::size_t byte_offset) {
+    bind_guard<UniformBuffer> guard(*this);
+    glBufferSubData(GL_UNIFORM_BUFFER, byte_offset, size, data);
+}
+
 } // namespace Saturn
@@ -23,10 +23,16 @@ VertexArray::VertexArray(CreateInfo const& create_info) {
     do_create(create_info);
 }
 
+VertexArray::VertexArray(Headless) : vao(headless), ebo(headless) {}
+
 VertexArray::~VertexArray() {}
 
 void VertexArray::assign(CreateInfo const& create_info) {
     if (vao.id != 0 && !buffers.empty() && ebo.id != 0) {
+        auto& cache = GLStateCache::get();
+        cache.forget_vertex_array(vao.id);
+        cache.forget_buffer(buffers[0]->id);
+        cache.forget_buffer(ebo.id);
         glDeleteVertexArrays(1, &vao.id);
         glDeleteBuffers(1, &buffers[0]->id);
         glDeleteBuffers(1, &ebo.id);
@@ -40,15 +46,11 @@ void VertexArray::assign(CreateInfo const& create_info) {
 std::size_t VertexArray::size() const { return vertex_count; }
 std::size_t VertexArray::index_size() const { return indices_size; }
 
-void VertexArray::bind(VertexArray& buf) {
-    glBindVertexArray(buf.vao.id);
-    Ebo::bind(buf.ebo);
-}
+// The element buffer is part of the vertex array state, so it does not have
+// to be bound again
+void VertexArray::bind(VertexArray& buf) { Vao::bind(buf.vao); }
 
-void VertexArray::unbind() {
-    glBindVertexArray(0);
-    Ebo::unbind();
-}
+void VertexArray::unbind() { Vao::unbind(); }
 
 void VertexArray::do_create(CreateInfo const& create_info) {
     buffers.emplace_back();
@@ -151,7 +153,7 @@ std::size_t VertexArray::add_buffer(BufferInfo const& info) {
 }
 
 void VertexArray::update_buffer_data(std::size_t buffer_index,
-	float* data,
+	float const* data,
 	std::size_t count) {
 	auto& buf = *buffers[buffer_index];
     bind_guard vao_guard(vao);
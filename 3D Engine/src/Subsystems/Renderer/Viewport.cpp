@@ -16,7 +16,7 @@ Viewport::Viewport(unsigned int x,
     x(x),
     y(y), w(w), h(h) {}
 
-Viewport::Viewport(std::size_t cam,
+Viewport::Viewport(Entity cam,
                    unsigned int x,
                    unsigned int y,
                    unsigned int w,
@@ -48,12 +48,10 @@ void Viewport::set_active(Viewport const& viewport) {
 #pragma clang diagnostic ignored "-Wsign-conversion"
 #pragma clang diagnostic ignored "-Wc++11-narrowing"
 
-std::size_t Viewport::get_camera() const { return camera; }
-void Viewport::set_camera(std::size_t cam_id) { camera = cam_id; }
+Entity Viewport::get_camera() const { return camera; }
+void Viewport::set_camera(Entity cam) { camera = cam; }
 
-bool Viewport::has_camera() const {
-    return camera != static_cast<std::size_t>(-1);
-}
+bool Viewport::has_camera() const { return camera.valid(); }
 
 #pragma clang diagnostic pop
 
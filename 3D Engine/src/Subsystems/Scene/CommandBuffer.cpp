@@ -0,0 +1,70 @@
+#include "Subsystems/Scene/CommandBuffer.hpp"
+
+#include "Subsystems/ECS/ComponentList.hpp"
+#include "Subsystems/Scene/Scene.hpp"
+
+namespace Saturn {
+
+namespace {
+
+template<typename... Cs>
+void reserve_components(
+    ECS<Cs...>& ecs,
+    std::array<std::size_t, SceneObject::component_count> const& counts) {
+    using table = SceneObject::component_table;
+    ((counts[table::get<Cs>()] != 0
+          ? ecs.template reserve<Cs>(counts[table::get<Cs>()])
+          : void()),
+     ...);
+}
+
+} // namespace
+
+void CommandBuffer::create_object(Entity parent /* = Entity{} */,
+                                  ObjectCallback init /* = nullptr */) {
+    record(SceneObject::component_count,
+           [parent, init = std::move(init)](Scene& scene) {
+               auto& obj = scene.create_object(scene.get_object(parent));
+               if (init) { init(obj); }
+           });
+}
+
+void CommandBuffer::destroy_object(Entity entity) {
+    record(SceneObject::component_count,
+           [entity](Scene& scene) { scene.destroy_object(entity); });
+}
+
+void CommandBuffer::apply(Scene& scene) {
+    std::array<std::size_t, SceneObject::component_count> adds;
+    {
+        std::lock_guard lock(mutex);
+        batch.swap(commands);
+        adds = pending_adds;
+        pending_adds.fill(0);
+    }
+
+    // Grow every container at most once for the whole batch
+    reserve_components(scene.get_ecs(), adds);
+    for (auto& command : batch) { command(scene); }
+    // Keeps the memory, so recording the next frame does not allocate
+    batch.clear();
+}
+
+bool CommandBuffer::empty() const {
+    std::lock_guard lock(mutex);
+    return commands.empty();
+}
+
+SceneObject* CommandBuffer::object(Scene& scene, Entity entity) {
+    return scene.get_object(entity);
+}
+
+void CommandBuffer::record(std::size_t component, Command command) {
+    std::lock_guard lock(mutex);
+    commands.push_back(std::move(command));
+    if (component != SceneObject::component_count) {
+        ++pending_adds[component];
+    }
+}
+
+} // namespace Saturn
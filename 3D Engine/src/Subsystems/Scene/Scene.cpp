@@ -1,18 +1,79 @@
 #include "Subsystems/Scene/Scene.hpp"
 
 #include "Core/Application.hpp"
+#include "Subsystems/Scene/CommandBuffer.hpp"
 #include "Subsystems/Scene/SceneObject.hpp"
+#include "Subsystems/Serialization/ComponentSerializers.hpp"
+#include "Subsystems/Time/Time.hpp"
 
+#include <cmath>
 #include <filesystem>
 #include <fstream>
+#include <nlohmann/json.hpp>
 
 namespace Saturn {
 
-Scene::Scene(Application* app) : ecs(this), app(app) {}
+namespace {
+
+// Same output as SceneObject::serialize_components
+template<typename... Cs>
+void serialize_components(SceneSnapshot const& snapshot,
+                          Entity entity,
+                          nlohmann::json& j) {
+    ((snapshot.ecs.has_component<Cs>(entity)
+          ? j.update(nlohmann::json(snapshot.ecs.get_component<Cs>(entity)))
+          : void()),
+     ...);
+}
+
+} // namespace
+
+Scene::Scene(Application* app) :
+    ecs(this), commands(std::make_unique<CommandBuffer>()), app(app) {}
 
 Scene::~Scene() {}
 
-void Scene::update_systems() { ecs.update_systems(); }
+void Scene::update_systems() {
+    bool const fixed = ecs.has_fixed_systems();
+    if (fixed) { run_fixed_steps(); }
+
+    ecs.update_systems();
+    // Sync point for structural changes made during the update
+    commands->apply(*this);
+    destroy_pending_objects();
+    transforms.update(*this);
+    // World matrices are final for this frame from here on
+    if (fixed) { transforms.interpolate(*this, Time::fixedAlpha); }
+}
+
+void Scene::run_fixed_steps() {
+    float const frame_time = Time::deltaTime;
+    fixed_time_accumulator += frame_time;
+
+    // Fixed update systems see the step length as their delta time
+    Time::deltaTime = Time::fixedDeltaTime;
+    int steps = 0;
+    while (fixed_time_accumulator >= Time::fixedDeltaTime &&
+           steps < Time::maxFixedSteps) {
+        transforms.begin_fixed_step();
+        ecs.fixed_update_systems();
+        commands->apply(*this);
+        destroy_pending_objects();
+        transforms.update(*this, true);
+        fixed_time_accumulator -= Time::fixedDeltaTime;
+        ++steps;
+    }
+    // Drop what could not be simulated instead of catching up over the next
+    // frames
+    if (fixed_time_accumulator >= Time::fixedDeltaTime) {
+        fixed_time_accumulator =
+            std::fmod(fixed_time_accumulator, Time::fixedDeltaTime);
+    }
+
+    Time::deltaTime = frame_time;
+    Time::fixedAlpha = fixed_time_accumulator / Time::fixedDeltaTime;
+}
+
 void Scene::on_start() { ecs.on_start(); }
 
 Application* Scene::get_app() {
@@ -20,8 +81,20 @@ Application* Scene::get_app() {
 }
 
 SceneObject& Scene::create_object(SceneObject* parent /* = nullptr*/) {
-    objects.push_back(std::make_unique<SceneObject>(this, parent));
-    return *objects.back();
+    std::uint32_t index;
+    if (!free_slots.empty()) {
+        index = free_slots.back();
+        free_slots.pop_back();
+    } else {
+        index = static_cast<std::uint32_t>(entities.size());
+        entities.emplace_back();
+    }
+    auto& slot = entities[index];
+    Entity const entity{index, slot.generation};
+    slot.object = std::make_unique<SceneObject>(
+        this, entity, parent ? parent->get_entity() : Entity{});
+    transforms.invalidate();
+    return *slot.object;
 }
 
 SceneObject&
@@ -32,19 +105,115 @@ Scene::create_object_from_file(std::string_view file_path,
     nlohmann::json j;
     f >> j;
     j.get_to(object);
-    object.parent_obj = parent;
+    object.parent_entity = parent ? parent->get_entity() : Entity{};
     object.scene = this;
     return object;
 }
 
+void Scene::destroy_object(Entity entity) {
+    if (!is_alive(entity)) { return; }
+    auto& slot = entities[entity.index];
+    if (slot.destroy_pending) { return; }
+    slot.destroy_pending = true;
+    pending_destroy.push_back(entity);
+}
+
+void Scene::destroy_objects(std::vector<Entity> const& entities_to_destroy) {
+    pending_destroy.reserve(pending_destroy.size() +
+                            entities_to_destroy.size());
+    for (auto entity : entities_to_destroy) { destroy_object(entity); }
+}
+
+void Scene::destroy_pending_objects() {
+    if (pending_destroy.empty()) { return; }
+
+    // Children are destroyed with their parents. One pass over the entity
+    // table picks up all descendants of pending objects.
+    for (auto& slot : entities) {
+        if (!slot.object || slot.destroy_pending) { continue; }
+        if (has_pending_ancestor(*slot.object)) {
+            pending_destroy.push_back(slot.object->get_entity());
+        }
+    }
+    for (auto entity : pending_destroy) {
+        entities[entity.index].destroy_pending = true;
+    }
+
+    ecs.destroy_entities(pending_destroy);
+
+    for (auto entity : pending_destroy) {
+        auto& slot = entities[entity.index];
+        slot.object.reset();
+        slot.destroy_pending = false;
+        // Invalidates all handles to the destroyed object
+        ++slot.generation;
+        free_slots.push_back(entity.index);
+    }
+    pending_destroy.clear();
+    transforms.invalidate();
+}
+
+bool Scene::has_pending_ancestor(SceneObject const& object) const {
+    for (auto const* parent = object.parent(); parent != nullptr;
+         parent = parent->parent()) {
+        if (entities[parent->get_entity().index].destroy_pending) {
+            return true;
+        }
+    }
+    return false;
+}
+
+SceneObject* Scene::get_object(Entity entity) {
+    if (!is_alive(entity)) { return nullptr; }
+    return entities[entity.index].object.get();
+}
+
+SceneObject const* Scene::get_object(Entity entity) const {
+    if (!is_alive(entity)) { return nullptr; }
+    return entities[entity.index].object.get();
+}
+
+bool Scene::is_alive(Entity entity) const {
+    return entity.index < entities.size() &&
+           entities[entity.index].generation == entity.generation &&
+           entities[entity.index].object != nullptr;
+}
+
 void Scene::serialize_to_file(std::string_view folder) {
+    SceneSnapshot snapshot;
+    capture_snapshot(snapshot);
+    serialize_snapshot(snapshot, folder);
+}
+
+void Scene::capture_snapshot(SceneSnapshot& out) {
+    ecs.capture(out.ecs);
+    out.entities.clear();
+    for (auto& slot : entities) {
+        if (slot.object) { out.entities.push_back(slot.object->get_entity()); }
+    }
+}
+
+void Scene::publish_snapshot() {
+    snapshots.publish([this](SceneSnapshot& back) { capture_snapshot(back); });
+}
+
+snapshot_buffer<SceneSnapshot>::read_handle Scene::latest_snapshot() {
+    return snapshots.acquire();
+}
+
+void Scene::serialize_snapshot(SceneSnapshot const& snapshot,
+                               std::string_view folder) {
     namespace fs = std::filesystem;
     fs::create_directories(folder.data() + std::string("/entities"));
     std::ofstream file(folder.data() + std::string("/scene.dat"));
-    for (std::size_t i = 0; i < objects.size(); ++i) {
+    std::size_t i = 0;
+    for (auto entity : snapshot.entities) {
         auto fname = folder.data() + std::string("/entities/") +
-                     std::to_string(i) + ".json";
-        objects[i]->serialize_to_file(fname);
+                     std::to_string(i++) + ".json";
+        nlohmann::json json;
+        serialize_components<COMPONENT_LIST>(snapshot, entity, json);
+        std::ofstream entity_file(fname);
+        entity_file << json.dump(4);
         file << fname << "\n";
     }
 }
@@ -57,4 +226,6 @@ void Scene::deserialize_from_file(std::string_view path) {
 
 ECS<COMPONENT_LIST>& Scene::get_ecs() { return ecs; }
 
+CommandBuffer& Scene::get_commands() { return *commands; }
+
 } // namespace Saturn
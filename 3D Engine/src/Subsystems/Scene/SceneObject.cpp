@@ -16,14 +16,18 @@
 
 namespace Saturn {
 
-SceneObject::SceneObject(Scene* s, SceneObject* parent /*= nullptr*/) :
-    scene(s), parent_obj(parent) {}
+SceneObject::SceneObject(Scene* s,
+                         Entity handle,
+                         Entity parent /*= Entity{}*/) :
+    scene(s), entity(handle), parent_entity(parent) {}
 
-bool SceneObject::has_parent() const { return parent_obj != nullptr; }
+bool SceneObject::has_parent() const { return parent() != nullptr; }
 
-SceneObject* SceneObject::parent() { return parent_obj; }
+SceneObject* SceneObject::parent() { return scene->get_object(parent_entity); }
 
-SceneObject const* SceneObject::parent() const { return parent_obj; }
+SceneObject const* SceneObject::parent() const {
+    return scene->get_object(parent_entity);
+}
 
 void SceneObject::serialize_to_file(std::string_view path) {
     nlohmann::json json;
@@ -54,7 +58,7 @@ void from_json(nlohmann::json const& j, SceneObject& obj) {
             ->get_app()
             ->get_renderer()
             ->get_viewport(camera.viewport_id)
-            .set_camera(camera.id);
+            .set_camera(obj.get_entity());
     }
     if (auto const& fps = j.find("FPSCameraControllerComponent");
         fps != j.end()) {
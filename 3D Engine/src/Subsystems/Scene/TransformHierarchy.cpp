@@ -0,0 +1,249 @@
+#include "Subsystems/Scene/TransformHierarchy.hpp"
+
+#include "Subsystems/ECS/Components/Transform.hpp"
+#include "Subsystems/Math/Math.hpp"
+#include "Subsystems/Scene/Scene.hpp"
+
+#include <algorithm>
+
+namespace Saturn {
+
+namespace {
+
+// Returns the closest ancestor of object that has a Transform
+SceneObject const* transform_parent(SceneObject const& object) {
+    auto const* parent = object.parent();
+    while (parent && !parent->has_component<Components::Transform>()) {
+        parent = parent->parent();
+    }
+    return parent;
+}
+
+} // namespace
+
+void TransformHierarchy::update(Scene& scene, bool fixed_step) {
+    using Components::Transform;
+
+    auto& ecs = scene.get_ecs();
+    if (needs_rebuild) {
+        rebuild(scene);
+        needs_rebuild = false;
+    }
+
+    // Parents come first, so a node can tell whether its parent was
+    // recomputed already
+    auto const since = last_update_tick;
+    batch.clear();
+    targets.clear();
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        auto const& node = nodes[i];
+        // Set by rebuild for new nodes and nodes that got a different parent
+        bool const forced = dirty[i];
+        bool const parent_dirty =
+            node.parent != no_parent && dirty[node.parent];
+        if (!forced && !parent_dirty &&
+            !tick_newer(ecs.get_ticks<Transform>(node.entity).changed, since)) {
+            dirty[i] = false;
+            continue;
+        }
+        dirty[i] = true;
+
+        auto& transform = ecs.get_component<Transform>(node.entity);
+        auto position = transform.position;
+        auto rotation = transform.rotation;
+        auto scale = transform.scale;
+        if (node.parent != no_parent) {
+            position += absolute.position_at(node.parent);
+            // Renormalized to keep rounding errors from building up along
+            // deep hierarchies
+            rotation =
+                glm::normalize(absolute.rotation_at(node.parent) * rotation);
+            scale *= absolute.scale_at(node.parent);
+        }
+
+        if (fixed_step) {
+            // Interpolated from where the node was before this step, unless
+            // it did not exist or was somewhere else in the hierarchy
+            if (forced) {
+                previous.set(i, position, rotation, scale);
+            } else {
+                previous.set(i, absolute.position_at(i),
+                             absolute.rotation_at(i), absolute.scale_at(i));
+            }
+            if (motion[i] == Motion::none) {
+                interpolated.push_back(static_cast<std::uint32_t>(i));
+            }
+            motion[i] = Motion::moving;
+        } else if (motion[i] != Motion::none) {
+            // Moved outside of a fixed step, which is shown right away
+            previous.set(i, position, rotation, scale);
+        }
+
+        absolute.set(i, position, rotation, scale);
+        batch.push_back(position, rotation, scale);
+        targets.push_back(&transform);
+    }
+
+    write_batch();
+    dirty.assign(nodes.size(), false);
+
+    // Writing the world matrices stamped the recomputed transforms as
+    // changed. Taking the tick after that keeps them from being recomputed
+    // again next update, while systems and the renderer still see them.
+    last_update_tick = ecs.advance_tick();
+}
+
+void TransformHierarchy::begin_fixed_step() {
+    // Nodes that moved in the previous step come to rest at their current
+    // transform, unless they move again in this one
+    for (auto i : interpolated) {
+        previous.set(i, absolute.position_at(i), absolute.rotation_at(i),
+                     absolute.scale_at(i));
+        motion[i] = Motion::settling;
+    }
+}
+
+void TransformHierarchy::interpolate(Scene& scene, float alpha) {
+    using Components::Transform;
+
+    if (interpolated.empty()) { return; }
+
+    auto& ecs = scene.get_ecs();
+    batch.clear();
+    targets.clear();
+    std::size_t kept = 0;
+    for (auto i : interpolated) {
+        batch.push_back(
+            glm::mix(previous.position_at(i), absolute.position_at(i), alpha),
+            glm::slerp(previous.rotation_at(i), absolute.rotation_at(i),
+                       alpha),
+            glm::mix(previous.scale_at(i), absolute.scale_at(i), alpha));
+        targets.push_back(&ecs.get_component<Transform>(nodes[i].entity));
+        // Settling nodes are written at their current transform now and
+        // need no further interpolation
+        if (motion[i] == Motion::settling) {
+            motion[i] = Motion::none;
+        } else {
+            interpolated[kept++] = i;
+        }
+    }
+    interpolated.resize(kept);
+
+    write_batch();
+    last_update_tick = ecs.advance_tick();
+}
+
+void TransformHierarchy::invalidate() { needs_rebuild = true; }
+
+void TransformHierarchy::write_batch() {
+    // Build the matrices of all nodes in the batch at once
+    matrices.resize(batch.size());
+    rotations.resize(batch.size());
+    Math::compose_model_matrices(batch, matrices.data(), rotations.data());
+    for (std::size_t i = 0; i < targets.size(); ++i) {
+        targets[i]->world_matrix = matrices[i];
+        targets[i]->world_rotation = rotations[i];
+    }
+}
+
+void TransformHierarchy::rebuild(Scene& scene) {
+    using Components::Transform;
+
+    auto& ecs = scene.get_ecs();
+
+    struct Entry {
+        SceneObject const* object;
+        std::uint32_t depth;
+    };
+    std::vector<Entry> entries;
+    std::uint32_t max_index = 0;
+    for (auto [transform] : ecs.select<Transform const>()) {
+        auto const* object = scene.get_object(transform.entity);
+        std::uint32_t depth = 0;
+        for (auto const* p = transform_parent(*object); p;
+             p = transform_parent(*p)) {
+            ++depth;
+        }
+        entries.push_back({object, depth});
+        max_index = std::max(max_index, transform.entity.index);
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](Entry const& a, Entry const& b) {
+                         return a.depth < b.depth;
+                     });
+
+    // Carry over the state of nodes that are still alive, so that their clean
+    // children do not have to be recomputed and their interpolation goes on
+    std::vector<std::uint32_t> old_position(std::size_t(max_index) + 1,
+                                            no_parent);
+    for (std::size_t i = 0; i < nodes.size(); ++i) {
+        auto const index = nodes[i].entity.index;
+        if (index <= max_index) {
+            old_position[index] = static_cast<std::uint32_t>(i);
+        }
+    }
+
+    std::vector<std::uint32_t> position(std::size_t(max_index) + 1,
+                                        no_parent);
+    std::vector<Node> new_nodes;
+    Math::TransformLanes new_absolute;
+    Math::TransformLanes new_previous;
+    std::vector<Motion> new_motion;
+    std::vector<bool> forced;
+    new_nodes.reserve(entries.size());
+    new_absolute.reserve(entries.size());
+    new_previous.reserve(entries.size());
+    new_motion.reserve(entries.size());
+    forced.reserve(entries.size());
+    interpolated.clear();
+    for (auto const& entry : entries) {
+        auto const entity = entry.object->get_entity();
+        auto const* parent = transform_parent(*entry.object);
+        auto const parent_entity = parent ? parent->get_entity() : Entity{};
+        auto const pos = static_cast<std::uint32_t>(new_nodes.size());
+        position[entity.index] = pos;
+        new_nodes.push_back(
+            {entity, parent ? position[parent_entity.index] : no_parent});
+
+        // The slot of a destroyed object may have been reused, in which case
+        // this is a new node as well
+        auto old = old_position[entity.index];
+        if (old != no_parent && nodes[old].entity != entity) {
+            old = no_parent;
+        }
+        if (old != no_parent) {
+            new_absolute.push_back(absolute.position_at(old),
+                                   absolute.rotation_at(old),
+                                   absolute.scale_at(old));
+            new_previous.push_back(previous.position_at(old),
+                                   previous.rotation_at(old),
+                                   previous.scale_at(old));
+            new_motion.push_back(motion[old]);
+            if (motion[old] != Motion::none) { interpolated.push_back(pos); }
+        } else {
+            new_absolute.push_back(glm::vec3(0.0f),
+                                   glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                                   glm::vec3(1.0f));
+            new_previous.push_back(glm::vec3(0.0f),
+                                   glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                                   glm::vec3(1.0f));
+            new_motion.push_back(Motion::none);
+        }
+        // New nodes are recomputed, and so is a node whose closest
+        // transformed ancestor changed (because that ancestor lost its
+        // Transform)
+        auto const old_parent =
+            old != no_parent && nodes[old].parent != no_parent
+                ? nodes[nodes[old].parent].entity
+                : Entity{};
+        forced.push_back(old == no_parent || old_parent != parent_entity);
+    }
+
+    nodes = std::move(new_nodes);
+    absolute = std::move(new_absolute);
+    previous = std::move(new_previous);
+    motion = std::move(new_motion);
+    dirty = std::move(forced);
+}
+
+} // namespace Saturn
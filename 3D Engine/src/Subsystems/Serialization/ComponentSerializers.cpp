@@ -16,7 +16,9 @@ void from_json(nlohmann::json const& json, Transform& transform) {
             "No Transform component stored even though it was requested");
     } else {
         transform.position = (*trans)["Position"].get<glm::vec3>();
-        transform.rotation = (*trans)["Rotation"].get<glm::vec3>();
+        // Stored as euler angles in degrees
+        transform.rotation =
+            Math::euler_to_quat((*trans)["Rotation"].get<glm::vec3>());
         transform.scale = (*trans)["Scale"].get<glm::vec3>();
     }
 }
@@ -277,7 +279,7 @@ void to_json(nlohmann::json& json, Transform const& transform) {
     // clang-format off
     json["TransformComponent"] = nlohmann::json::object({
 		{"Position", transform.position},
-		{"Rotation", transform.rotation},
+		{"Rotation", Math::quat_to_euler(transform.rotation)},
 		{"Scale", transform.scale}
 		});
     // clang-format on
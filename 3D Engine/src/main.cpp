@@ -21,6 +21,7 @@ int main() try {
     engine_create_info.app_create_info.fullscreen = false;
     engine_create_info.app_create_info.window_caption = "Saturn Engine";
     engine_create_info.app_create_info.window_size = {800, 600};
+    engine_create_info.app_create_info.pipelined_rendering = true;
     engine_create_info.enable_debug_output = true;
     Saturn::Application app = Saturn::Engine::initialize(engine_create_info);
     app.run();
@@ -0,0 +1,61 @@
+#ifndef MVG_BENCHMARK_HPP_
+#define MVG_BENCHMARK_HPP_
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace Saturn::Benchmarks {
+
+// Runs fn repetitions times and returns the fastest run in microseconds.
+// The fastest run is the one least disturbed by other processes.
+template<typename F>
+double best_time_us(F&& fn, int repetitions = 7) {
+    double best = 0.0;
+    for (int i = 0; i < repetitions; ++i) {
+        auto const start = std::chrono::steady_clock::now();
+        fn();
+        std::chrono::duration<double, std::micro> const time =
+            std::chrono::steady_clock::now() - start;
+        if (i == 0 || time.count() < best) { best = time.count(); }
+    }
+    return best;
+}
+
+// Like best_time_us, but calls setup before every run without timing it
+template<typename S, typename F>
+double best_time_us(S&& setup, F&& fn, int repetitions = 7) {
+    double best = 0.0;
+    for (int i = 0; i < repetitions; ++i) {
+        setup();
+        double const time = best_time_us(fn, 1);
+        if (i == 0 || time < best) { best = time; }
+    }
+    return best;
+}
+
+// Stores value where the compiler cannot see it, so that the work that
+// computed it is not optimized away
+template<typename T>
+void keep(T const& value) {
+    [[maybe_unused]] static volatile T sink;
+    sink = value;
+}
+
+// The indices 0 to count - 1 in a random order that only depends on seed
+inline std::vector<std::uint32_t> shuffled_indices(std::size_t count,
+                                                   std::uint32_t seed = 1) {
+    std::vector<std::uint32_t> indices(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        indices[i] = static_cast<std::uint32_t>(i);
+    }
+    std::shuffle(indices.begin(), indices.end(), std::mt19937(seed));
+    return indices;
+}
+
+} // namespace Saturn::Benchmarks
+
+#endif
@@ -0,0 +1,71 @@
+// Measures how much of the available threads' time the job system spends on
+// jobs that take 1 to 10 us each, once as separately scheduled jobs and once
+// as a parallel_for with one job per index.
+
+#include "Subsystems/JobSystem/JobSystem.hpp"
+
+#include "Benchmark.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+using namespace Saturn;
+using namespace Saturn::Benchmarks;
+
+namespace {
+
+constexpr std::size_t job_count = 10'000;
+
+// Stands in for a job's work by keeping its thread busy for us microseconds
+void spin(double us) {
+    auto const end = std::chrono::steady_clock::now() +
+                     std::chrono::duration<double, std::micro>(us);
+    while (std::chrono::steady_clock::now() < end) {}
+}
+
+void run(double job_us) {
+    std::vector<JobHandle> handles;
+    handles.reserve(job_count);
+    double const schedule_us = best_time_us(
+        [&] { handles.clear(); },
+        [&] {
+            for (std::size_t i = 0; i < job_count; ++i) {
+                handles.push_back(JobSystem::schedule([=] { spin(job_us); }));
+            }
+            JobSystem::wait(handles);
+        },
+        3);
+    double const parallel_for_us = best_time_us(
+        [&] {
+            JobSystem::parallel_for(job_count, 1,
+                                    [=](std::size_t begin, std::size_t end) {
+                                        for (auto i = begin; i < end; ++i) {
+                                            spin(job_us);
+                                        }
+                                    });
+        },
+        3);
+
+    // The waiting thread runs jobs as well
+    double const threads =
+        static_cast<double>(JobSystem::worker_count() + 1);
+    double const ideal_us = job_us * job_count / threads;
+    std::printf("%6.0f %14.0f %10.1f%% %14.0f %10.1f%%\n", job_us,
+                job_count / schedule_us * 1e6, ideal_us / schedule_us * 100.0,
+                job_count / parallel_for_us * 1e6,
+                ideal_us / parallel_for_us * 100.0);
+}
+
+} // namespace
+
+int main() {
+    JobSystem::initialize();
+    std::printf("%zu jobs on %zu workers and the main thread\n", job_count,
+                JobSystem::worker_count());
+    std::printf("%6s %14s %11s %14s %11s\n", "job us", "schedule/s",
+                "efficiency", "for/s", "efficiency");
+    for (double const job_us : {1.0, 2.0, 5.0, 10.0}) { run(job_us); }
+    JobSystem::shutdown();
+}
@@ -0,0 +1,140 @@
+// Measures what a SceneObject costs in memory and how fast queries over many
+// objects are. The component signature bitset is compared with the
+// type_index -> id map SceneObject used before.
+
+#include "Subsystems/ECS/Components/PointLight.hpp"
+#include "Subsystems/ECS/Components/Rotator.hpp"
+#include "Subsystems/ECS/Components/Transform.hpp"
+#include "Subsystems/Scene/Scene.hpp"
+#include "Subsystems/Scene/SceneObject.hpp"
+
+#include "Benchmark.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Bytes requested from operator new so far. Includes memory that growing
+// containers free again, so it is an upper bound of what is in use.
+std::atomic<std::size_t> allocated_bytes{0};
+
+} // namespace
+
+void* operator new(std::size_t size) {
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) { return ptr; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+using namespace Saturn;
+using namespace Saturn::Benchmarks;
+using namespace Saturn::Components;
+
+namespace {
+
+// Component bookkeeping of the previous SceneObject
+class map_object {
+public:
+    template<typename C>
+    void add_component(std::size_t id) {
+        component_ids[std::type_index(typeid(C))] = id;
+    }
+
+    template<typename... Cs>
+    bool has_components() const {
+        return (component_ids.count(std::type_index(typeid(Cs))) && ...);
+    }
+
+private:
+    std::unordered_map<std::type_index, std::size_t> component_ids;
+};
+
+void run(std::size_t count) {
+    // Every object has a Transform and a Rotator, every other one a light
+    Scene scene(nullptr);
+    std::vector<SceneObject*> objects;
+    objects.reserve(count);
+    auto const before_objects = allocated_bytes.load();
+    for (std::size_t i = 0; i < count; ++i) {
+        auto& object = scene.create_object();
+        object.add_component<Transform>();
+        object.add_component<Rotator>();
+        if (i % 2 == 0) { object.add_component<PointLight>(); }
+        objects.push_back(&object);
+    }
+    auto const scene_bytes = allocated_bytes.load() - before_objects;
+
+    auto const before_maps = allocated_bytes.load();
+    std::vector<map_object> maps(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        maps[i].add_component<Transform>(i);
+        maps[i].add_component<Rotator>(i);
+        if (i % 2 == 0) { maps[i].add_component<PointLight>(i); }
+    }
+    auto const map_bytes = allocated_bytes.load() - before_maps;
+
+    double const n = static_cast<double>(count);
+    std::printf("%zu objects\n", count);
+    std::printf("  allocated bytes per object: scene %.0f (SceneObject %zu, "
+                "signature %zu)\n",
+                static_cast<double>(scene_bytes) / n, sizeof(SceneObject),
+                sizeof(SceneObject::signature_type));
+    std::printf("  allocated bytes per object: type_index map alone %.0f\n",
+                static_cast<double>(map_bytes) / n);
+
+    double const signature_us = best_time_us([&] {
+        std::size_t matches = 0;
+        for (auto const* object : objects) {
+            matches += object->has_components<Transform, PointLight>();
+        }
+        keep(matches);
+    });
+    double const map_us = best_time_us([&] {
+        std::size_t matches = 0;
+        for (auto const& map : maps) {
+            matches += map.has_components<Transform, PointLight>();
+        }
+        keep(matches);
+    });
+    std::printf("  has_components ns per object: signature %.2f, map %.2f\n",
+                signature_us * 1000.0 / n, map_us * 1000.0 / n);
+
+    auto& ecs = scene.get_ecs();
+    double const view_us = best_time_us([&] {
+        float sum = 0.0f;
+        for (auto [transform, light] :
+             ecs.select<Transform const, PointLight const>()) {
+            sum += transform.position.x + light.intensity;
+        }
+        keep(sum);
+    });
+    ecs.register_query<Transform const, PointLight const>();
+    double const query_us = best_time_us([&] {
+        float sum = 0.0f;
+        for (auto [transform, light] :
+             ecs.query<Transform const, PointLight const>()) {
+            sum += transform.position.x + light.intensity;
+        }
+        keep(sum);
+    });
+    std::printf("  Transform + PointLight ns per object: select %.2f, "
+                "persistent query %.2f\n",
+                view_us * 1000.0 / n, query_us * 1000.0 / n);
+}
+
+} // namespace
+
+int main() {
+    for (std::size_t const count : {10'000u, 100'000u}) { run(count); }
+}
@@ -0,0 +1,103 @@
+// Compares building model matrices with compose_model_matrices from
+// structure of arrays lanes against composing them one transform at a time
+// with glm, for 10k to 1M transforms.
+
+#include "Subsystems/Math/Math.hpp"
+#include "Subsystems/Math/Transform.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include "Benchmark.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace Saturn;
+using namespace Saturn::Benchmarks;
+
+namespace {
+
+// Array of structures layout, like Components::Transform
+struct transform {
+    glm::vec3 position;
+    glm::quat rotation;
+    glm::vec3 scale;
+};
+
+void compose_scalar(std::vector<transform> const& transforms,
+                    glm::mat4* matrices,
+                    glm::mat3* rotations) {
+    for (std::size_t i = 0; i < transforms.size(); ++i) {
+        auto const& t = transforms[i];
+        matrices[i] = glm::scale(glm::translate(glm::mat4(1.0f), t.position) *
+                                     glm::mat4_cast(t.rotation),
+                                 t.scale);
+        rotations[i] = glm::mat3_cast(t.rotation);
+    }
+}
+
+void run(std::size_t count) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> angle(-360.0f, 360.0f);
+    std::uniform_real_distribution<float> scale(0.1f, 3.0f);
+
+    std::vector<transform> transforms(count);
+    Math::TransformLanes lanes;
+    lanes.reserve(count);
+    for (auto& t : transforms) {
+        t.position = {position(rng), position(rng), position(rng)};
+        t.rotation = Math::euler_to_quat({angle(rng), angle(rng), angle(rng)});
+        t.scale = {scale(rng), scale(rng), scale(rng)};
+        lanes.push_back(t.position, t.rotation, t.scale);
+    }
+
+    std::vector<glm::mat4> scalar_matrices(count);
+    std::vector<glm::mat3> scalar_rotations(count);
+    std::vector<glm::mat4> lane_matrices(count);
+    std::vector<glm::mat3> lane_rotations(count);
+
+    double const scalar_us = best_time_us([&] {
+        compose_scalar(transforms, scalar_matrices.data(),
+                       scalar_rotations.data());
+    });
+    double const lanes_us = best_time_us([&] {
+        Math::compose_model_matrices(lanes, lane_matrices.data(),
+                                     lane_rotations.data());
+    });
+
+    // Both have to produce the same matrices for the comparison to be fair
+    float max_error = 0.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                float const expected = scalar_matrices[i][column][row];
+                float const error =
+                    std::abs(lane_matrices[i][column][row] - expected) /
+                    (1.0f + std::abs(expected));
+                max_error = std::max(max_error, error);
+            }
+        }
+    }
+
+    double const n = static_cast<double>(count);
+    std::printf("%8zu %12.2f %12.2f %8.2fx %12.3g\n", count,
+                scalar_us * 1000.0 / n, lanes_us * 1000.0 / n,
+                scalar_us / lanes_us, max_error);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%8s %12s %12s %9s %12s\n", "count", "glm ns", "lanes ns",
+                "speedup", "max error");
+    for (std::size_t const count : {10'000u, 100'000u, 1'000'000u}) {
+        run(count);
+    }
+}
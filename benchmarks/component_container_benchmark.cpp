@@ -0,0 +1,120 @@
+// Compares the paged sparse set component_container uses to find components
+// by entity index with the unordered_map it replaced, at 10k, 100k and 1M
+// entities. Iterating the dense components is measured as well, since the
+// sparse set must not make the systems' loops slower.
+
+#include "Subsystems/ECS/Components/Rotator.hpp"
+#include "Subsystems/ECS/component_container.hpp"
+
+#include "Benchmark.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_map>
+#include <vector>
+
+using namespace Saturn;
+using namespace Saturn::Benchmarks;
+using Components::Rotator;
+
+namespace {
+
+// The previous component_container layout: dense components plus a hash map
+// from entity index to position
+class map_container {
+public:
+    void push_back(Rotator const& c) {
+        id_index_map[c.entity.index] = components.size();
+        components.push_back(c);
+    }
+
+    Rotator& get_with_id(std::size_t id) {
+        return components[id_index_map.find(id)->second];
+    }
+
+    void erase_component(std::size_t id) {
+        auto const it = id_index_map.find(id);
+        auto const erased_idx = it->second;
+        if (erased_idx != components.size() - 1) {
+            components[erased_idx] = components.back();
+            id_index_map[components[erased_idx].entity.index] = erased_idx;
+        }
+        id_index_map.erase(it);
+        components.pop_back();
+    }
+
+    std::vector<Rotator>::iterator begin() { return components.begin(); }
+    std::vector<Rotator>::iterator end() { return components.end(); }
+
+private:
+    std::vector<Rotator> components;
+    std::unordered_map<std::size_t, std::size_t> id_index_map;
+};
+
+Rotator make_rotator(std::uint32_t index) {
+    Rotator rotator{};
+    rotator.entity.index = index;
+    rotator.speed = static_cast<float>(index % 13);
+    return rotator;
+}
+
+template<typename Container>
+void fill(Container& container, std::vector<std::uint32_t> const& ids) {
+    for (auto const id : ids) { container.push_back(make_rotator(id)); }
+}
+
+template<typename Container>
+void run(char const* name, std::vector<std::uint32_t> const& ids) {
+    // Lookups in a different order than the components were added in
+    auto const lookups = shuffled_indices(ids.size(), 2);
+
+    Container container;
+    double const insert_us =
+        best_time_us([&] { container = Container(); },
+                     [&] { fill(container, ids); });
+
+    double const lookup_us = best_time_us([&] {
+        float sum = 0.0f;
+        for (auto const id : lookups) {
+            sum += container.get_with_id(id).speed;
+        }
+        keep(sum);
+    });
+
+    double const iterate_us = best_time_us([&] {
+        float sum = 0.0f;
+        for (auto const& rotator : container) { sum += rotator.speed; }
+        keep(sum);
+    });
+
+    // Every other entity in lookup order loses its component
+    double const erase_us = best_time_us(
+        [&] {
+            container = Container();
+            fill(container, ids);
+        },
+        [&] {
+            for (std::size_t i = 0; i < lookups.size(); i += 2) {
+                container.erase_component(lookups[i]);
+            }
+        });
+
+    double const count = static_cast<double>(ids.size());
+    std::printf("%-20s %8zu %12.2f %12.2f %12.2f %12.2f\n", name,
+                ids.size(), insert_us * 1000.0 / count,
+                lookup_us * 1000.0 / count, iterate_us * 1000.0 / count,
+                erase_us * 2000.0 / count);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%-20s %8s %12s %12s %12s %12s\n", "container", "entities",
+                "insert ns", "lookup ns", "iterate ns", "erase ns");
+    for (std::size_t const count : {10'000u, 100'000u, 1'000'000u}) {
+        auto const ids = shuffled_indices(count);
+        run<component_container<Rotator>>("sparse set", ids);
+        run<map_container>("unordered_map", ids);
+    }
+}
@@ -0,0 +1,113 @@
+// Measures how recording mesh draws into RenderCommandLists scales from 1 to
+// N threads. Draws are recorded the way Renderer::record_queue does it: a
+// parallel_for over ranges of 512 meshes, each range into a list of its own,
+// and the lists appended in order afterwards.
+//
+// Usage: draw_list_benchmark [max threads], which defaults to the hardware
+// thread count.
+
+#include "Subsystems/JobSystem/JobSystem.hpp"
+#include "Subsystems/Renderer/RenderCommandList.hpp"
+#include "Subsystems/Renderer/Shader.hpp"
+#include "Subsystems/Renderer/Texture.hpp"
+#include "Subsystems/Renderer/VertexArray.hpp"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "Benchmark.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace Saturn;
+using namespace Saturn::Benchmarks;
+
+namespace {
+
+// Same as Renderer::MeshesPerRecordJob
+constexpr std::size_t meshes_per_job = 512;
+// Meshes that share a material, like after sorting the render queue
+constexpr std::size_t meshes_per_material = 16;
+
+struct MeshSet {
+    Shader shader;
+    std::vector<Texture> textures;
+    // Recording only stores its address, so it needs no OpenGL objects
+    VertexArray vertices{headless};
+    std::vector<glm::mat4> models;
+
+    explicit MeshSet(std::size_t mesh_count) :
+        textures(mesh_count / meshes_per_material + 1),
+        models(mesh_count, glm::mat4(1.0f)) {}
+};
+
+// Like Renderer::record_opaque_draws, without the lighting uniforms
+void record_range(MeshSet& meshes,
+                  std::size_t begin,
+                  std::size_t end,
+                  RenderCommandList& list) {
+    for (std::size_t i = begin; i < end; ++i) {
+        if (i == begin || i % meshes_per_material == 0) {
+            list.active_texture(GL_TEXTURE0);
+            list.bind_texture(meshes.textures[i / meshes_per_material]);
+            list.set_uniform(meshes.shader, 1, 0.5f);
+        }
+        list.set_uniform(meshes.shader, 0, meshes.models[i]);
+        list.draw_elements(meshes.shader, meshes.vertices);
+    }
+}
+
+class Recorder {
+public:
+    void record(MeshSet& meshes, RenderCommandList& list) {
+        list.reset();
+        auto const count = meshes.models.size();
+        auto const job_count = (count + meshes_per_job - 1) / meshes_per_job;
+        if (lists.size() < job_count) { lists.resize(job_count); }
+        JobSystem::parallel_for(
+            count, meshes_per_job, [&](std::size_t begin, std::size_t end) {
+                auto& out = lists[begin / meshes_per_job];
+                out.reset();
+                record_range(meshes, begin, end, out);
+            });
+        for (std::size_t i = 0; i < job_count; ++i) { list.append(lists[i]); }
+    }
+
+private:
+    std::vector<RenderCommandList> lists;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::size_t max_threads = std::thread::hardware_concurrency();
+    if (argc > 1) { max_threads = std::strtoul(argv[1], nullptr, 10); }
+    if (max_threads == 0) { max_threads = 1; }
+
+    std::printf("%8s %8s %12s %9s\n", "meshes", "threads", "us / frame",
+                "speedup");
+    for (std::size_t const mesh_count : {10'000u, 50'000u, 100'000u}) {
+        MeshSet meshes(mesh_count);
+        double single_thread_us = 0.0;
+        for (std::size_t threads = 1; threads <= max_threads; ++threads) {
+            // The calling thread records as well
+            JobSystem::initialize(threads - 1);
+            Recorder recorder;
+            RenderCommandList list;
+            // The first frame grows the lists
+            recorder.record(meshes, list);
+            double const us =
+                best_time_us([&] { recorder.record(meshes, list); });
+            keep(list.size_bytes());
+            JobSystem::shutdown();
+
+            if (threads == 1) { single_thread_us = us; }
+            std::printf("%8zu %8zu %12.1f %8.2fx\n", mesh_count, threads, us,
+                        single_thread_us / us);
+        }
+    }
+}
@@ -0,0 +1,108 @@
+// Simulates frames of a scene with 100k entities in which 1% of the entities
+// gain or lose a component every frame, and compares iterating a persistent
+// query with searching the component pools through select every frame.
+
+#include "Subsystems/ECS/Components/PointLight.hpp"
+#include "Subsystems/ECS/Components/Rotator.hpp"
+#include "Subsystems/ECS/Components/Transform.hpp"
+#include "Subsystems/Scene/Scene.hpp"
+#include "Subsystems/Scene/SceneObject.hpp"
+
+#include "Benchmark.hpp"
+
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+using namespace Saturn;
+using namespace Saturn::Benchmarks;
+using namespace Saturn::Components;
+
+namespace {
+
+constexpr std::size_t entity_count = 100'000;
+constexpr std::size_t churn_per_frame = entity_count / 100;
+constexpr int frame_count = 100;
+
+class churn_scene {
+public:
+    explicit churn_scene(bool persistent) : persistent(persistent) {
+        objects.reserve(entity_count);
+        for (std::size_t i = 0; i < entity_count; ++i) {
+            auto& object = scene.create_object();
+            object.add_component<Transform>();
+            object.add_component<Rotator>();
+            if (i % 2 == 0) { object.add_component<PointLight>(); }
+            objects.push_back(&object);
+        }
+        if (persistent) {
+            scene.get_ecs().register_query<Transform const, PointLight>();
+        }
+    }
+
+    // Toggles the light of the next 1% of the entities
+    void churn() {
+        for (std::size_t i = 0; i < churn_per_frame; ++i) {
+            auto& object = *objects[next];
+            if (object.has_component<PointLight>()) {
+                object.remove_component<PointLight>();
+            } else {
+                object.add_component<PointLight>();
+            }
+            // Steps through the entities in a scattered order
+            next = (next + 7919) % entity_count;
+        }
+    }
+
+    void iterate() {
+        auto const update = [](Transform const& transform, PointLight& light) {
+            light.intensity = transform.position.x + 1.0f;
+        };
+        auto& ecs = scene.get_ecs();
+        if (persistent) {
+            for (auto [transform, light] :
+                 ecs.query<Transform const, PointLight>()) {
+                update(transform, light);
+            }
+        } else {
+            for (auto [transform, light] :
+                 ecs.select<Transform const, PointLight>()) {
+                update(transform, light);
+            }
+        }
+    }
+
+private:
+    Scene scene{nullptr};
+    std::vector<SceneObject*> objects;
+    bool persistent;
+    std::size_t next = 0;
+};
+
+void run(char const* name, bool persistent) {
+    churn_scene scene(persistent);
+    double const churn_us = best_time_us([&] {
+        for (int frame = 0; frame < frame_count; ++frame) { scene.churn(); }
+    });
+    double const iterate_us = best_time_us([&] {
+        for (int frame = 0; frame < frame_count; ++frame) { scene.iterate(); }
+    });
+    double const frame_us = best_time_us([&] {
+        for (int frame = 0; frame < frame_count; ++frame) {
+            scene.churn();
+            scene.iterate();
+        }
+    });
+    std::printf("%-18s %12.1f %12.1f %12.1f\n", name, churn_us / frame_count,
+                iterate_us / frame_count, frame_us / frame_count);
+}
+
+} // namespace
+
+int main() {
+    std::printf("%zu entities, %zu change per frame, us per frame\n",
+                entity_count, churn_per_frame);
+    std::printf("%-18s %12s %12s %12s\n", "", "churn", "iterate", "both");
+    run("select", false);
+    run("persistent query", true);
+}
@@ -1,6 +1,6 @@
 #version 430 core
 
-#define MAX_LIGHTS_PER_TYPE 15
+// MAX_LIGHTS_PER_TYPE is defined by Shader from LightsBlock::MaxLightsPerType
 
 in vec2 TexCoords;
 in vec3 Normal;
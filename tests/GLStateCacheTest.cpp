@@ -0,0 +1,215 @@
+// Drives a GLStateCache with a function table that records the calls instead
+// of issuing them, and checks which calls reach OpenGL and which are
+// filtered.
+
+#include "Subsystems/Renderer/GLStateCache.hpp"
+
+#include "TestCheck.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace Saturn;
+
+namespace {
+
+// Calls that reached the function table, in order
+std::vector<std::string> calls;
+
+// Formats a call like the recording functions do, e.g. "use_program(3)"
+template<typename... Args>
+std::string call(char const* name, Args... args) {
+    std::string result = name;
+    result += '(';
+    ((result += std::to_string(args) + ','), ...);
+    if (sizeof...(Args) != 0) { result.pop_back(); }
+    result += ')';
+    return result;
+}
+
+GLStateCache::Functions recording_functions() {
+    GLStateCache::Functions functions;
+    functions.use_program = [](GLuint program) {
+        calls.push_back(call("use_program", program));
+    };
+    functions.bind_vertex_array = [](GLuint vertex_array) {
+        calls.push_back(call("bind_vertex_array", vertex_array));
+    };
+    functions.active_texture = [](GLenum unit) {
+        calls.push_back(call("active_texture", unit));
+    };
+    functions.bind_texture = [](GLenum target, GLuint texture) {
+        calls.push_back(call("bind_texture", target, texture));
+    };
+    functions.bind_buffer = [](GLenum target, GLuint buffer) {
+        calls.push_back(call("bind_buffer", target, buffer));
+    };
+    functions.bind_buffer_base = [](GLenum target, GLuint index,
+                                    GLuint buffer) {
+        calls.push_back(call("bind_buffer_base", target, index, buffer));
+    };
+    functions.bind_framebuffer = [](GLenum target, GLuint framebuffer) {
+        calls.push_back(call("bind_framebuffer", target, framebuffer));
+    };
+    functions.enable = [](GLenum capability) {
+        calls.push_back(call("enable", capability));
+    };
+    functions.disable = [](GLenum capability) {
+        calls.push_back(call("disable", capability));
+    };
+    functions.blend_func = [](GLenum source, GLenum destination) {
+        calls.push_back(call("blend_func", source, destination));
+    };
+    functions.cull_face = [](GLenum face) {
+        calls.push_back(call("cull_face", face));
+    };
+    functions.depth_func = [](GLenum func) {
+        calls.push_back(call("depth_func", func));
+    };
+    return functions;
+}
+
+// Binding the same state for every draw only reaches OpenGL once
+void test_repeated_state() {
+    calls.clear();
+    GLStateCache cache(recording_functions());
+    for (int draw = 0; draw < 10; ++draw) {
+        cache.bind_framebuffer(2);
+        cache.use_program(3);
+        cache.bind_vertex_array(7);
+        cache.bind_texture(GL_TEXTURE0, GL_TEXTURE_2D, 5);
+        cache.enable(GL_DEPTH_TEST);
+        cache.blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        cache.cull_face(GL_BACK);
+        cache.depth_func(GL_LESS);
+    }
+
+    std::vector<std::string> const expected = {
+        call("bind_framebuffer", GL_FRAMEBUFFER, 2),
+        call("use_program", 3),
+        call("bind_vertex_array", 7),
+        call("active_texture", GL_TEXTURE0),
+        call("bind_texture", GL_TEXTURE_2D, 5),
+        call("enable", GL_DEPTH_TEST),
+        call("blend_func", GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA),
+        call("cull_face", GL_BACK),
+        call("depth_func", GL_LESS)};
+    CHECK(calls == expected);
+    CHECK(cache.get_stats().issued == expected.size());
+    // bind_texture with a unit filters once and skips activating the unit
+    CHECK(cache.get_stats().filtered == 9 * 8);
+
+    cache.reset_stats();
+    CHECK(cache.get_stats().issued == 0);
+    CHECK(cache.get_stats().filtered == 0);
+}
+
+// Only actual changes are forwarded, and state that is not cached always is
+void test_changes() {
+    calls.clear();
+    GLStateCache cache(recording_functions());
+    cache.enable(GL_BLEND);
+    cache.disable(GL_BLEND);
+    cache.disable(GL_BLEND);
+    cache.enable(GL_SCISSOR_TEST);
+    cache.enable(GL_SCISSOR_TEST);
+    cache.use_program(1);
+    cache.use_program(2);
+    cache.use_program(2);
+    cache.blend_func(GL_ONE, GL_ONE);
+    cache.blend_func(GL_ONE, GL_ZERO);
+    // Texture units keep their own bindings
+    cache.bind_texture(GL_TEXTURE0, GL_TEXTURE_2D, 4);
+    cache.bind_texture(GL_TEXTURE1, GL_TEXTURE_2D, 4);
+    cache.bind_texture(GL_TEXTURE0, GL_TEXTURE_2D, 4);
+    cache.bind_texture(GL_TEXTURE1, GL_TEXTURE_CUBE_MAP, 6);
+
+    std::vector<std::string> const expected = {
+        call("enable", GL_BLEND),
+        call("disable", GL_BLEND),
+        call("enable", GL_SCISSOR_TEST),
+        call("enable", GL_SCISSOR_TEST),
+        call("use_program", 1),
+        call("use_program", 2),
+        call("blend_func", GL_ONE, GL_ONE),
+        call("blend_func", GL_ONE, GL_ZERO),
+        call("active_texture", GL_TEXTURE0),
+        call("bind_texture", GL_TEXTURE_2D, 4),
+        call("active_texture", GL_TEXTURE1),
+        call("bind_texture", GL_TEXTURE_2D, 4),
+        call("bind_texture", GL_TEXTURE_CUBE_MAP, 6)};
+    CHECK(calls == expected);
+    CHECK(cache.get_stats().issued == expected.size());
+    // The second disable and use_program, the repeated texture binding and
+    // activating the unit that is already active
+    CHECK(cache.get_stats().filtered == 4);
+}
+
+// Changes OpenGL makes on its own have to be mirrored by the cache
+void test_implicit_changes() {
+    calls.clear();
+    GLStateCache cache(recording_functions());
+    cache.bind_vertex_array(1);
+    cache.bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 8);
+    cache.bind_buffer(GL_ARRAY_BUFFER, 9);
+    // The element array buffer belongs to the vertex array
+    cache.bind_vertex_array(2);
+    cache.bind_buffer(GL_ELEMENT_ARRAY_BUFFER, 8);
+    cache.bind_buffer(GL_ARRAY_BUFFER, 9);
+
+    // Deleting a bound texture binds 0 in its place
+    cache.bind_texture(GL_TEXTURE0, GL_TEXTURE_2D, 5);
+    cache.forget_texture(5);
+    cache.bind_texture(GL_TEXTURE0, GL_TEXTURE_2D, 0);
+    cache.bind_texture(GL_TEXTURE0, GL_TEXTURE_2D, 5);
+
+    // Binding to an indexed target binds the generic target as well
+    cache.bind_buffer_base(GL_UNIFORM_BUFFER, 1, 11);
+    cache.bind_buffer(GL_UNIFORM_BUFFER, 11);
+    cache.bind_buffer_base(GL_UNIFORM_BUFFER, 1, 11);
+
+    std::vector<std::string> const expected = {
+        call("bind_vertex_array", 1),
+        call("bind_buffer", GL_ELEMENT_ARRAY_BUFFER, 8),
+        call("bind_buffer", GL_ARRAY_BUFFER, 9),
+        call("bind_vertex_array", 2),
+        call("bind_buffer", GL_ELEMENT_ARRAY_BUFFER, 8),
+        call("active_texture", GL_TEXTURE0),
+        call("bind_texture", GL_TEXTURE_2D, 5),
+        call("bind_texture", GL_TEXTURE_2D, 5),
+        call("bind_buffer_base", GL_UNIFORM_BUFFER, 1, 11)};
+    CHECK(calls == expected);
+}
+
+// After invalidate, nothing is known and everything is forwarded again
+void test_invalidate() {
+    calls.clear();
+    GLStateCache cache(recording_functions());
+    cache.use_program(3);
+    cache.enable(GL_CULL_FACE);
+    cache.bind_framebuffer(0);
+    cache.invalidate();
+    cache.use_program(3);
+    cache.enable(GL_CULL_FACE);
+    cache.bind_framebuffer(0);
+
+    std::vector<std::string> const expected = {
+        call("use_program", 3),
+        call("enable", GL_CULL_FACE),
+        call("bind_framebuffer", GL_FRAMEBUFFER, 0),
+        call("use_program", 3),
+        call("enable", GL_CULL_FACE),
+        call("bind_framebuffer", GL_FRAMEBUFFER, 0)};
+    CHECK(calls == expected);
+    CHECK(cache.get_stats().filtered == 0);
+}
+
+} // namespace
+
+int main() {
+    test_repeated_state();
+    test_changes();
+    test_implicit_changes();
+    test_invalidate();
+    return Tests::failure_count() != 0;
+}
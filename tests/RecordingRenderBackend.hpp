@@ -0,0 +1,154 @@
+#ifndef MVG_RECORDING_RENDER_BACKEND_HPP_
+#define MVG_RECORDING_RENDER_BACKEND_HPP_
+
+#include "Subsystems/Renderer/RenderBackend.hpp"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Saturn::Tests {
+
+// One call the backend received. object is the Framebuffer, Shader, ...
+// the command refers to, or null. Integer arguments end up in args, float
+// arguments, matrices and uploaded data in values.
+struct RecordedCommand {
+    std::string name;
+    void const* object = nullptr;
+    void const* second_object = nullptr;
+    std::vector<unsigned int> args;
+    std::vector<float> values;
+};
+
+// RenderBackend that stores every call instead of issuing OpenGL calls, so
+// tests can check what a RenderCommandList replays
+class RecordingRenderBackend : public RenderBackend {
+public:
+    std::vector<RecordedCommand> commands;
+
+    std::vector<std::string> names() const {
+        std::vector<std::string> result;
+        for (auto const& command : commands) {
+            result.push_back(command.name);
+        }
+        return result;
+    }
+
+    void bind_framebuffer(Framebuffer& framebuffer) override {
+        record("bind_framebuffer", &framebuffer);
+    }
+    void unbind_framebuffer() override { record("unbind_framebuffer"); }
+    void bind_depth_map_framebuffer(DepthMap& depth_map) override {
+        record("bind_depth_map_framebuffer", &depth_map);
+    }
+    void set_viewport(unsigned int x,
+                      unsigned int y,
+                      unsigned int w,
+                      unsigned int h) override {
+        record("set_viewport").args = {x, y, w, h};
+    }
+
+    void set_clear_color(glm::vec4 const& color) override {
+        auto& command = record("set_clear_color");
+        command.values = {color.x, color.y, color.z, color.w};
+    }
+    void clear(unsigned int flags) override { record("clear").args = {flags}; }
+    void enable(unsigned int capability) override {
+        record("enable").args = {capability};
+    }
+    void disable(unsigned int capability) override {
+        record("disable").args = {capability};
+    }
+    void cull_face(unsigned int face) override {
+        record("cull_face").args = {face};
+    }
+    void blend_func(unsigned int source, unsigned int destination) override {
+        record("blend_func").args = {source, destination};
+    }
+
+    void active_texture(unsigned int unit) override {
+        record("active_texture").args = {unit};
+    }
+    void bind_texture(Texture& texture) override {
+        record("bind_texture", &texture);
+    }
+    void unbind_texture(Texture& texture) override {
+        record("unbind_texture", &texture);
+    }
+    void bind_depth_texture(DepthMap& depth_map) override {
+        record("bind_depth_texture", &depth_map);
+    }
+    void unbind_depth_texture() override { record("unbind_depth_texture"); }
+    void bind_texture_2d(unsigned int handle) override {
+        record("bind_texture_2d").args = {handle};
+    }
+
+    void set_uniform(Shader& shader, int location, int value) override {
+        auto& command = record("set_uniform_int", &shader);
+        command.args = {static_cast<unsigned int>(location),
+                        static_cast<unsigned int>(value)};
+    }
+    void set_uniform(Shader& shader, int location, float value) override {
+        auto& command = record("set_uniform_float", &shader);
+        command.args = {static_cast<unsigned int>(location)};
+        command.values = {value};
+    }
+    void set_uniform(Shader& shader,
+                     int location,
+                     glm::mat4 const& value) override {
+        auto& command = record("set_uniform_mat4", &shader);
+        command.args = {static_cast<unsigned int>(location)};
+        float const* elements = glm::value_ptr(value);
+        command.values.assign(elements, elements + 16);
+    }
+
+    void update_uniform_buffer(UniformBuffer& buffer,
+                               std::size_t byte_offset,
+                               void const* data,
+                               std::size_t size) override {
+        auto& command = record("update_uniform_buffer", &buffer);
+        command.args = {static_cast<unsigned int>(byte_offset),
+                        static_cast<unsigned int>(size)};
+        // Uniform data in the tests is made of floats
+        command.values.resize(size / sizeof(float));
+        std::memcpy(command.values.data(), data,
+                    command.values.size() * sizeof(float));
+    }
+    void update_vertex_buffer(VertexArray& vertices,
+                              std::size_t buffer_index,
+                              float const* data,
+                              std::size_t count) override {
+        auto& command = record("update_vertex_buffer", &vertices);
+        command.args = {static_cast<unsigned int>(buffer_index)};
+        command.values.assign(data, data + count);
+    }
+
+    void draw_elements(Shader& shader, VertexArray& vertices) override {
+        record("draw_elements", &shader).second_object = &vertices;
+    }
+    void draw_elements_instanced(Shader& shader,
+                                 VertexArray& vertices,
+                                 std::size_t instances) override {
+        auto& command = record("draw_elements_instanced", &shader);
+        command.second_object = &vertices;
+        command.args = {static_cast<unsigned int>(instances)};
+    }
+
+    void finish() override { record("finish"); }
+
+private:
+    RecordedCommand& record(char const* name, void const* object = nullptr) {
+        auto& command = commands.emplace_back();
+        command.name = name;
+        command.object = object;
+        return command;
+    }
+};
+
+} // namespace Saturn::Tests
+
+#endif
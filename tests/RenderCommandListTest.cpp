@@ -0,0 +1,208 @@
+// Records frames into RenderCommandLists and checks the calls a
+// RecordingRenderBackend receives when replaying them.
+
+#include "Subsystems/Renderer/DepthMap.hpp"
+#include "Subsystems/Renderer/RenderCommandList.hpp"
+#include "Subsystems/Renderer/Shader.hpp"
+#include "Subsystems/Renderer/Texture.hpp"
+#include "Subsystems/Renderer/UniformBuffer.hpp"
+#include "Subsystems/Renderer/VertexArray.hpp"
+#include "Subsystems/Renderer/Viewport.hpp"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "RecordingRenderBackend.hpp"
+#include "TestCheck.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace Saturn;
+using Saturn::Tests::RecordingRenderBackend;
+
+namespace {
+
+// The GPU objects do not create OpenGL objects when default constructed, or
+// headless for VertexArray
+struct Resources {
+    DepthMap depth_map;
+    Shader depth_shader;
+    Shader shader;
+    Shader particle_shader;
+    Texture texture;
+    UniformBuffer matrices;
+    VertexArray mesh{headless};
+    VertexArray particles{headless};
+};
+
+// Same structure as Renderer::record_frame: uploads, then the depth pass,
+// then the scene and the particles
+void record_frame(Resources& res, RenderCommandList& list) {
+    glm::mat4 model(1.0f);
+    model[3][0] = 5.0f;
+    float particle_data[] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+
+    list.update_uniform_buffer(res.matrices, 64,
+                               glm::vec4(1.0f, 2.0f, 3.0f, 4.0f));
+    list.update_vertex_buffer(res.particles, 1, particle_data, 6);
+    // The list keeps its own copy
+    particle_data[0] = -1.0f;
+
+    list.bind_depth_map_framebuffer(res.depth_map);
+    list.set_viewport(Viewport(0, 0, 1024, 1024));
+    list.clear(GL_DEPTH_BUFFER_BIT);
+    list.set_uniform(res.depth_shader, 0, model);
+    list.draw_elements(res.depth_shader, res.mesh);
+
+    list.unbind_framebuffer();
+    list.set_viewport(Viewport(0, 0, 800, 600));
+    list.set_clear_color(glm::vec4(0.1f, 0.2f, 0.3f, 1.0f));
+    list.clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    list.enable(GL_DEPTH_TEST);
+    list.active_texture(GL_TEXTURE0);
+    list.bind_texture(res.texture);
+    list.active_texture(GL_TEXTURE1);
+    list.bind_depth_texture(res.depth_map);
+    list.set_uniform(res.shader, 3, 1);
+    list.set_uniform(res.shader, 4, 0.5f);
+    list.draw_elements(res.shader, res.mesh);
+    list.unbind_depth_texture();
+    list.unbind_texture(res.texture);
+
+    list.enable(GL_BLEND);
+    list.blend_func(GL_SRC_ALPHA, GL_ONE);
+    list.draw_elements_instanced(res.particle_shader, res.particles, 2);
+    list.disable(GL_BLEND);
+}
+
+void test_replay_order() {
+    Resources res;
+    RenderCommandList list;
+    record_frame(res, list);
+
+    RecordingRenderBackend backend;
+    list.replay(backend);
+
+    std::vector<std::string> const expected = {
+        "update_uniform_buffer",      "update_vertex_buffer",
+        "bind_depth_map_framebuffer", "set_viewport",
+        "clear",                      "set_uniform_mat4",
+        "draw_elements",              "unbind_framebuffer",
+        "set_viewport",               "set_clear_color",
+        "clear",                      "enable",
+        "active_texture",             "bind_texture",
+        "active_texture",             "bind_depth_texture",
+        "set_uniform_int",            "set_uniform_float",
+        "draw_elements",              "unbind_depth_texture",
+        "unbind_texture",             "enable",
+        "blend_func",                 "draw_elements_instanced",
+        "disable",                    "finish"};
+    CHECK(backend.names() == expected);
+    // finish is not a recorded command
+    CHECK(list.command_count() == expected.size() - 1);
+    if (backend.commands.size() != expected.size()) { return; }
+
+    auto const& commands = backend.commands;
+    CHECK(commands[0].object == &res.matrices);
+    CHECK((commands[0].args == std::vector<unsigned int>{64, 16}));
+    CHECK((commands[0].values == std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f}));
+
+    CHECK(commands[1].object == &res.particles);
+    CHECK((commands[1].args == std::vector<unsigned int>{1}));
+    CHECK((commands[1].values ==
+           std::vector<float>{1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}));
+
+    CHECK(commands[2].object == &res.depth_map);
+    CHECK((commands[3].args == std::vector<unsigned int>{0, 0, 1024, 1024}));
+    CHECK((commands[4].args == std::vector<unsigned int>{GL_DEPTH_BUFFER_BIT}));
+
+    CHECK(commands[5].object == &res.depth_shader);
+    CHECK(commands[5].values.size() == 16 && commands[5].values[12] == 5.0f);
+    CHECK(commands[6].object == &res.depth_shader);
+    CHECK(commands[6].second_object == &res.mesh);
+
+    CHECK((commands[8].args == std::vector<unsigned int>{0, 0, 800, 600}));
+    CHECK((commands[9].values == std::vector<float>{0.1f, 0.2f, 0.3f, 1.0f}));
+    CHECK((commands[11].args == std::vector<unsigned int>{GL_DEPTH_TEST}));
+    CHECK((commands[12].args == std::vector<unsigned int>{GL_TEXTURE0}));
+    CHECK(commands[13].object == &res.texture);
+    CHECK(commands[15].object == &res.depth_map);
+    CHECK((commands[16].args == std::vector<unsigned int>{3, 1}));
+    CHECK((commands[17].values == std::vector<float>{0.5f}));
+    CHECK(commands[18].object == &res.shader);
+
+    CHECK((commands[22].args ==
+           std::vector<unsigned int>{GL_SRC_ALPHA, GL_ONE}));
+    CHECK(commands[23].object == &res.particle_shader);
+    CHECK(commands[23].second_object == &res.particles);
+    CHECK((commands[23].args == std::vector<unsigned int>{2}));
+}
+
+// Renderer records its draw lists on several threads and appends them to
+// the frame's list in order
+void test_append() {
+    Resources res;
+    RenderCommandList first;
+    first.bind_texture(res.texture);
+    first.bind_texture_2d(42);
+    first.draw_elements(res.shader, res.mesh);
+
+    RenderCommandList second;
+    float const data[] = {7.0f, 8.0f, 9.0f};
+    second.update_vertex_buffer(res.particles, 2, data, 3);
+    second.draw_elements_instanced(res.particle_shader, res.particles, 3);
+
+    RenderCommandList frame;
+    frame.enable(GL_DEPTH_TEST);
+    frame.append(first);
+    frame.append(second);
+    frame.disable(GL_DEPTH_TEST);
+    CHECK(frame.command_count() == 7);
+
+    RecordingRenderBackend backend;
+    frame.replay(backend);
+    std::vector<std::string> const expected = {
+        "enable",        "bind_texture",         "bind_texture_2d",
+        "draw_elements", "update_vertex_buffer", "draw_elements_instanced",
+        "disable",       "finish"};
+    CHECK(backend.names() == expected);
+    if (backend.commands.size() != expected.size()) { return; }
+    CHECK((backend.commands[2].args == std::vector<unsigned int>{42}));
+    CHECK((backend.commands[4].values == std::vector<float>{7.0f, 8.0f, 9.0f}));
+    CHECK((backend.commands[5].args == std::vector<unsigned int>{3}));
+}
+
+void test_reset() {
+    Resources res;
+    RenderCommandList list;
+    record_frame(res, list);
+    list.reset();
+    CHECK(list.empty());
+    CHECK(list.command_count() == 0);
+
+    RecordingRenderBackend empty_backend;
+    list.replay(empty_backend);
+    CHECK(empty_backend.names() == std::vector<std::string>{"finish"});
+
+    // Recording into the reused list gives the same frame again
+    record_frame(res, list);
+    RecordingRenderBackend reused_backend;
+    list.replay(reused_backend);
+
+    RenderCommandList fresh;
+    record_frame(res, fresh);
+    RecordingRenderBackend fresh_backend;
+    fresh.replay(fresh_backend);
+    CHECK(reused_backend.names() == fresh_backend.names());
+    CHECK(list.size_bytes() == fresh.size_bytes());
+}
+
+} // namespace
+
+int main() {
+    test_replay_order();
+    test_append();
+    test_reset();
+    return Tests::failure_count() != 0;
+}
@@ -0,0 +1,92 @@
+// Checks the std140 offsets, array strides and struct sizes against the
+// layouts the OpenGL specification gives for the same GLSL declarations.
+
+#include "Subsystems/Renderer/Std140.hpp"
+
+#include "TestCheck.hpp"
+
+using namespace Saturn;
+
+namespace {
+
+// Array elements are aligned like a vec4, so scalars and vec2s are padded
+void test_array_stride() {
+    CHECK(std140::array_stride(std140::Int) == 16);
+    CHECK(std140::array_stride(std140::Float) == 16);
+    CHECK(std140::array_stride(std140::Vec2) == 16);
+    CHECK(std140::array_stride(std140::Vec3) == 16);
+    CHECK(std140::array_stride(std140::Vec4) == 16);
+    CHECK(std140::array_stride(std140::Mat4) == 64);
+}
+
+void test_array() {
+    auto const floats = std140::array(std140::Float, 4);
+    CHECK(floats.alignment == 16);
+    CHECK(floats.size == 64);
+    auto const vec2s = std140::array(std140::Vec2, 3);
+    CHECK(vec2s.alignment == 16);
+    CHECK(vec2s.size == 48);
+    auto const matrices = std140::array(std140::Mat4, 2);
+    CHECK(matrices.alignment == 16);
+    CHECK(matrices.size == 128);
+}
+
+// vec3 v; float f;
+// A float fits in the last 4 bytes of the vec3, but not the other way round.
+void test_vec3_and_float() {
+    constexpr std140::Struct<2> packed{{std140::Vec3, std140::Float}};
+    CHECK(packed.offsets[0] == 0);
+    CHECK(packed.offsets[1] == 12);
+    CHECK(packed.size == 16);
+
+    constexpr std140::Struct<2> padded{{std140::Float, std140::Vec3}};
+    CHECK(padded.offsets[0] == 0);
+    CHECK(padded.offsets[1] == 16);
+    CHECK(padded.size == 32);
+}
+
+// float f; mat4 m; vec2 v;
+void test_mat4() {
+    constexpr std140::Struct<3> layout{
+        {std140::Float, std140::Mat4, std140::Vec2}};
+    CHECK(layout.offsets[0] == 0);
+    CHECK(layout.offsets[1] == 16);
+    CHECK(layout.offsets[2] == 80);
+    CHECK(layout.alignment == 16);
+    CHECK(layout.size == 96);
+}
+
+// struct Inner { vec3 v; float f; vec2 uv; };
+// int count; Inner inner[3]; float last;
+void test_array_of_structs() {
+    constexpr std140::Struct<3> inner{
+        {std140::Vec3, std140::Float, std140::Vec2}};
+    CHECK(inner.offsets[1] == 12);
+    CHECK(inner.offsets[2] == 16);
+    // Padded from 24 to a multiple of 16
+    CHECK(inner.size == 32);
+    CHECK(std140::array_stride(inner.type()) == 32);
+
+    constexpr std140::Struct<3> outer{
+        {std140::Int, std140::array(inner.type(), 3), std140::Float}};
+    CHECK(outer.offsets[0] == 0);
+    CHECK(outer.offsets[1] == 16);
+    CHECK(outer.offsets[2] == 112);
+    CHECK(outer.size == 128);
+
+    // A struct of a single float still takes a whole vec4 in an array
+    constexpr std140::Struct<1> single{{std140::Float}};
+    CHECK(single.size == 16);
+    CHECK(std140::array(single.type(), 2).size == 32);
+}
+
+} // namespace
+
+int main() {
+    test_array_stride();
+    test_array();
+    test_vec3_and_float();
+    test_mat4();
+    test_array_of_structs();
+    return Tests::failure_count() != 0;
+}
@@ -0,0 +1,26 @@
+#ifndef MVG_TEST_CHECK_HPP_
+#define MVG_TEST_CHECK_HPP_
+
+#include <cstdio>
+
+namespace Saturn::Tests {
+
+inline int& failure_count() {
+    static int count = 0;
+    return count;
+}
+
+} // namespace Saturn::Tests
+
+// Reports a failed check and keeps going, so that a single run shows every
+// failure. Tests return Saturn::Tests::failure_count() != 0 from main.
+#define CHECK(condition)                                                       \
+    do {                                                                       \
+        if (!(condition)) {                                                    \
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__,        \
+                         __LINE__, #condition);                                \
+            ++::Saturn::Tests::failure_count();                                \
+        }                                                                      \
+    } while (false)
+
+#endif
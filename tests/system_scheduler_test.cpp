@@ -0,0 +1,192 @@
+// Steps the same small scene with the systems running in parallel and in
+// sequential mode and checks that both end up with the same components.
+
+#include "Subsystems/ECS/Components/CameraZoomController.hpp"
+#include "Subsystems/ECS/Components/PointLight.hpp"
+#include "Subsystems/ECS/Components/Rotator.hpp"
+#include "Subsystems/ECS/Components/Transform.hpp"
+#include "Subsystems/ECS/Systems/SystemBase.hpp"
+#include "Subsystems/JobSystem/JobSystem.hpp"
+#include "Subsystems/Scene/Scene.hpp"
+#include "Subsystems/Scene/SceneObject.hpp"
+#include "Subsystems/Time/Time.hpp"
+
+#include "TestCheck.hpp"
+
+#include <cstddef>
+#include <vector>
+
+using namespace Saturn;
+using namespace Saturn::Components;
+
+namespace {
+
+constexpr std::size_t object_count = 64;
+constexpr int frame_count = 20;
+// Small enough to split the queries into several jobs
+constexpr std::size_t grain_size = 8;
+
+// Moves every object by its rotator speed
+class MoveSystem : public Systems::SystemBase {
+public:
+    using reads = Systems::access<Rotator>;
+    using writes = Systems::access<Transform>;
+
+    void on_start(Scene& scene) override {
+        scene.get_ecs().register_query<Transform, Rotator const>();
+    }
+
+    void on_update(Scene& scene) override {
+        scene.get_ecs().query<Transform, Rotator const>().parallel_for_each(
+            [](Transform& transform, Rotator const& rotator) {
+                transform.position.x += rotator.speed;
+                transform.position.y = transform.position.x * 0.5f;
+            },
+            grain_size);
+    }
+};
+
+// Conflicts with MoveSystem, so the result depends on running after it
+class AccelerateSystem : public Systems::SystemBase {
+public:
+    using writes = Systems::access<Rotator>;
+
+    void on_start(Scene& scene) override {
+        scene.get_ecs().register_query<Rotator>();
+    }
+
+    void on_update(Scene& scene) override {
+        scene.get_ecs().query<Rotator>().parallel_for_each(
+            [](Rotator& rotator) {
+                rotator.speed = rotator.speed * 1.5f + 1.0f;
+            },
+            grain_size);
+    }
+};
+
+// Reads what MoveSystem wrote
+class LightSystem : public Systems::SystemBase {
+public:
+    using reads = Systems::access<Transform>;
+    using writes = Systems::access<PointLight>;
+
+    void on_start(Scene& scene) override {
+        scene.get_ecs().register_query<PointLight, Transform const>();
+    }
+
+    void on_update(Scene& scene) override {
+        for (auto [light, transform] :
+             scene.get_ecs().query<PointLight, Transform const>()) {
+            light.intensity = light.intensity * 0.5f + transform.position.y;
+        }
+    }
+};
+
+// Touches nothing the other systems access, so it runs concurrently with them
+class ZoomSystem : public Systems::SystemBase {
+public:
+    using writes = Systems::access<CameraZoomController>;
+
+    void on_start(Scene& scene) override {
+        scene.get_ecs().register_query<CameraZoomController>();
+    }
+
+    void on_update(Scene& scene) override {
+        for (auto [zoom] : scene.get_ecs().query<CameraZoomController>()) {
+            zoom.zoom_speed += zoom.min_zoom;
+        }
+    }
+};
+
+struct ObjectState {
+    float position_x;
+    float position_y;
+    float speed;
+    float intensity;
+    float zoom_speed;
+};
+
+std::vector<ObjectState> step_scene(system_scheduler::mode mode) {
+    Scene scene(nullptr);
+    auto& ecs = scene.get_ecs();
+    ecs.register_system<MoveSystem>();
+    ecs.register_system<AccelerateSystem>();
+    ecs.register_system<LightSystem>();
+    ecs.register_system<ZoomSystem>();
+    ecs.set_update_mode(mode);
+
+    std::vector<SceneObject*> objects;
+    for (std::size_t i = 0; i < object_count; ++i) {
+        auto& object = scene.create_object();
+        object.add_component<Transform>();
+        object.add_component<Rotator>();
+        object.get_component<Rotator>().speed = static_cast<float>(i % 7);
+        // Only some objects match every query
+        if (i % 3 == 0) {
+            object.add_component<PointLight>();
+            object.get_component<PointLight>().intensity = 1.0f;
+        }
+        if (i % 4 == 0) {
+            object.add_component<CameraZoomController>();
+            auto& zoom = object.get_component<CameraZoomController>();
+            zoom.zoom_speed = 0.0f;
+            zoom.min_zoom = static_cast<float>(i);
+        }
+        objects.push_back(&object);
+    }
+
+    scene.on_start();
+    for (int frame = 0; frame < frame_count; ++frame) {
+        scene.update_systems();
+    }
+
+    std::vector<ObjectState> states;
+    for (auto* object : objects) {
+        ObjectState state{};
+        auto const& transform = object->get_component<Transform>();
+        state.position_x = transform.position.x;
+        state.position_y = transform.position.y;
+        state.speed = object->get_component<Rotator>().speed;
+        if (object->has_component<PointLight>()) {
+            state.intensity = object->get_component<PointLight>().intensity;
+        }
+        if (object->has_component<CameraZoomController>()) {
+            state.zoom_speed =
+                object->get_component<CameraZoomController>().zoom_speed;
+        }
+        states.push_back(state);
+    }
+    return states;
+}
+
+} // namespace
+
+int main() {
+    // Parallel mode falls back to sequential without workers, so make sure
+    // there are some even on a single core machine
+    JobSystem::initialize(3);
+    Time::deltaTime = 1.0f / 60.0f;
+
+    auto const parallel = step_scene(system_scheduler::mode::parallel);
+    auto const sequential = step_scene(system_scheduler::mode::sequential);
+
+    CHECK(parallel.size() == object_count);
+    CHECK(sequential.size() == object_count);
+    if (parallel.size() == object_count && sequential.size() == object_count) {
+        for (std::size_t i = 0; i < object_count; ++i) {
+            // Same operations in the same order, so the results match exactly
+            CHECK(parallel[i].position_x == sequential[i].position_x);
+            CHECK(parallel[i].position_y == sequential[i].position_y);
+            CHECK(parallel[i].speed == sequential[i].speed);
+            CHECK(parallel[i].intensity == sequential[i].intensity);
+            CHECK(parallel[i].zoom_speed == sequential[i].zoom_speed);
+        }
+        // The systems actually ran
+        CHECK(sequential[1].position_x > 0.0f);
+        CHECK(sequential[3].intensity != 1.0f);
+        CHECK(sequential[4].zoom_speed == 4.0f * frame_count);
+    }
+
+    JobSystem::shutdown();
+    return Tests::failure_count() != 0;
+}